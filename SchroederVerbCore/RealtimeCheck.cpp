@@ -0,0 +1,863 @@
+/*
+  ==============================================================================
+
+    RealtimeCheck.cpp
+
+    The hooks work by defining the libc functions in this object file, which
+    takes precedence over the shared libc for the final executable. Allocation
+    calls forward to glibc's __libc_* entry points, everything else forwards to
+    the next definition found with dlsym (RTLD_NEXT).
+
+    That only catches calls that go through exported libc symbols, libc calls
+    its own internals directly (printf ends in an internal write, for one).
+    On x86_64 the first ScopedAudioThread on a thread also installs a seccomp
+    filter on it that turns the blocking, I/O and memory mapping syscalls
+    into SIGSYS, so whatever path reaches the kernel is caught there. The
+    handler reports it when the thread is inside a scope and then makes the
+    syscall itself through a small trampoline, the one place the filter
+    lets them through, so the program carries on as if nothing happened.
+
+  ==============================================================================
+*/
+
+#include "RealtimeCheck.h"
+
+#include <atomic>
+
+#if defined (__linux__) && defined (__GLIBC__)
+
+#include <cerrno>
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+#include <dlfcn.h>
+#include <execinfo.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <sched.h>
+#include <semaphore.h>
+#include <time.h>
+#include <unistd.h>
+
+#if defined (__x86_64__)
+ #define SCHROEDERVERB_RTCHECK_SECCOMP 1
+ #include <csignal>
+ #include <cstddef>
+ #include <cstdint>
+ #include <linux/audit.h>
+ #include <linux/filter.h>
+ #include <linux/seccomp.h>
+ #include <sys/prctl.h>
+ #include <sys/syscall.h>
+ #include <ucontext.h>
+#else
+ #define SCHROEDERVERB_RTCHECK_SECCOMP 0
+#endif
+
+namespace
+{
+    thread_local bool tIsAudioThread = false;
+    thread_local bool tInHook = false;
+    std::atomic<int> gNumViolations { 0 };
+
+    using WriteFn = ssize_t (*) (int, const void*, size_t);
+    using ReadFn = ssize_t (*) (int, void*, size_t);
+    using OpenFn = int (*) (const char*, int, ...);
+    using OpenAtFn = int (*) (int, const char*, int, ...);
+    using CloseFn = int (*) (int);
+    using FOpenFn = FILE* (*) (const char*, const char*);
+    using FWriteFn = size_t (*) (const void*, size_t, size_t, FILE*);
+    using FFlushFn = int (*) (FILE*);
+    using NanosleepFn = int (*) (const struct timespec*, struct timespec*);
+    using UsleepFn = int (*) (useconds_t);
+    using SchedYieldFn = int (*) ();
+    using MutexFn = int (*) (pthread_mutex_t*);
+    using MutexTimedFn = int (*) (pthread_mutex_t*, const struct timespec*);
+    using MutexClockFn = int (*) (pthread_mutex_t*, clockid_t, const struct timespec*);
+    using CondWaitFn = int (*) (pthread_cond_t*, pthread_mutex_t*);
+    using CondTimedWaitFn = int (*) (pthread_cond_t*, pthread_mutex_t*, const struct timespec*);
+    using CondClockWaitFn = int (*) (pthread_cond_t*, pthread_mutex_t*, clockid_t, const struct timespec*);
+    using RwLockFn = int (*) (pthread_rwlock_t*);
+    using RwLockTimedFn = int (*) (pthread_rwlock_t*, const struct timespec*);
+    using SemFn = int (*) (sem_t*);
+    using SemTimedFn = int (*) (sem_t*, const struct timespec*);
+    using SemClockFn = int (*) (sem_t*, clockid_t, const struct timespec*);
+    using VFPrintfFn = int (*) (FILE*, const char*, va_list);
+    using PutsFn = int (*) (const char*);
+    using FPutsFn = int (*) (const char*, FILE*);
+    using PutCharFn = int (*) (int);
+    using FPutCFn = int (*) (int, FILE*);
+    using SyscallFn = long (*) (long, ...);
+
+    WriteFn realWrite;
+    ReadFn realRead;
+    OpenFn realOpen;
+    OpenAtFn realOpenAt;
+    CloseFn realClose;
+    FOpenFn realFOpen;
+    FWriteFn realFWrite;
+    FFlushFn realFFlush;
+    NanosleepFn realNanosleep;
+    UsleepFn realUsleep;
+    SchedYieldFn realSchedYield;
+    MutexFn realMutexLock;
+    MutexFn realMutexTryLock;
+    MutexTimedFn realMutexTimedLock;
+    MutexClockFn realMutexClockLock;
+    CondWaitFn realCondWait;
+    CondTimedWaitFn realCondTimedWait;
+    CondClockWaitFn realCondClockWait;
+    RwLockFn realRwLockRdLock;
+    RwLockFn realRwLockWrLock;
+    RwLockFn realRwLockTryRdLock;
+    RwLockFn realRwLockTryWrLock;
+    RwLockTimedFn realRwLockTimedRdLock;
+    RwLockTimedFn realRwLockTimedWrLock;
+    SemFn realSemWait;
+    SemFn realSemTryWait;
+    SemTimedFn realSemTimedWait;
+    SemClockFn realSemClockWait;
+    VFPrintfFn realVFPrintf;
+    PutsFn realPuts;
+    FPutsFn realFPuts;
+    PutCharFn realPutChar;
+    FPutCFn realFPutC;
+    FPutCFn realPutC;
+    SyscallFn realSyscall;
+
+    template <typename Fn>
+    void resolve (Fn& fn, const char* name)
+    {
+        fn = reinterpret_cast<Fn> (dlsym (RTLD_NEXT, name));
+    }
+
+    // called the first time any hook runs, and from a static constructor so the audio thread never has to
+    void resolveAll()
+    {
+        static std::atomic<bool> resolved { false };
+
+        if (resolved.load())
+            return;
+
+        bool wasInHook = tInHook;
+        tInHook = true;
+
+        resolve (realWrite, "write");
+        resolve (realRead, "read");
+        resolve (realOpen, "open");
+        resolve (realOpenAt, "openat");
+        resolve (realClose, "close");
+        resolve (realFOpen, "fopen");
+        resolve (realFWrite, "fwrite");
+        resolve (realFFlush, "fflush");
+        resolve (realNanosleep, "nanosleep");
+        resolve (realUsleep, "usleep");
+        resolve (realSchedYield, "sched_yield");
+        resolve (realMutexLock, "pthread_mutex_lock");
+        resolve (realMutexTryLock, "pthread_mutex_trylock");
+        resolve (realMutexTimedLock, "pthread_mutex_timedlock");
+        resolve (realMutexClockLock, "pthread_mutex_clocklock");
+        resolve (realCondWait, "pthread_cond_wait");
+        resolve (realCondTimedWait, "pthread_cond_timedwait");
+        resolve (realCondClockWait, "pthread_cond_clockwait");
+        resolve (realRwLockRdLock, "pthread_rwlock_rdlock");
+        resolve (realRwLockWrLock, "pthread_rwlock_wrlock");
+        resolve (realRwLockTryRdLock, "pthread_rwlock_tryrdlock");
+        resolve (realRwLockTryWrLock, "pthread_rwlock_trywrlock");
+        resolve (realRwLockTimedRdLock, "pthread_rwlock_timedrdlock");
+        resolve (realRwLockTimedWrLock, "pthread_rwlock_timedwrlock");
+        resolve (realSemWait, "sem_wait");
+        resolve (realSemTryWait, "sem_trywait");
+        resolve (realSemTimedWait, "sem_timedwait");
+        resolve (realSemClockWait, "sem_clockwait");
+        resolve (realVFPrintf, "vfprintf");
+        resolve (realPuts, "puts");
+        resolve (realFPuts, "fputs");
+        resolve (realPutChar, "putchar");
+        resolve (realFPutC, "fputc");
+        resolve (realPutC, "putc");
+        resolve (realSyscall, "syscall");
+
+        // backtrace() loads libgcc and allocates on its first call, get that out of the way now
+        void* frames[4];
+        backtrace (frames, 4);
+
+        resolved.store (true);
+        tInHook = wasInHook;
+    }
+
+    __attribute__ ((constructor)) void initialiseHooks()
+    {
+        resolveAll();
+    }
+
+    void reportViolation (const char* what, bool isSyscall = false)
+    {
+        if (! tIsAudioThread || tInHook)
+            return;
+
+        tInHook = true;
+        resolveAll();
+        ++gNumViolations;
+
+        char message[160];
+        int length = snprintf (message, sizeof (message), isSyscall ? "\n*** real-time violation: %s syscall made on the audio thread\n"
+                                                                    : "\n*** real-time violation: %s() called on the audio thread\n", what);
+
+        if (realWrite != nullptr && length > 0)
+            realWrite (STDERR_FILENO, message, (size_t) length);
+
+        void* frames[64];
+        int numFrames = backtrace (frames, 64);
+        backtrace_symbols_fd (frames, numFrames, STDERR_FILENO);
+
+        tInHook = false;
+    }
+
+    // marks the real call a hook forwards to, so the syscalls it makes underneath aren't reported a second time
+    struct ForwardedCall
+    {
+        ForwardedCall() : mWasInHook (tInHook)     { tInHook = true; }
+        ~ForwardedCall()                           { tInHook = mWasInHook; }
+
+        bool mWasInHook;
+    };
+
+   #if SCHROEDERVERB_RTCHECK_SECCOMP
+    //==============================================================================
+    // makes a syscall from the one address the filter below lets through, and returns the raw kernel result
+    extern "C" long sv_rtcheck_syscall (long number, long arg1, long arg2, long arg3, long arg4, long arg5, long arg6);
+    extern "C" const char sv_rtcheck_syscall_return[];
+
+    asm (".text\n"
+         ".globl sv_rtcheck_syscall\n"
+         ".hidden sv_rtcheck_syscall\n"
+         ".type sv_rtcheck_syscall, @function\n"
+         "sv_rtcheck_syscall:\n"
+         "    movq %rdi, %rax\n"
+         "    movq %rsi, %rdi\n"
+         "    movq %rdx, %rsi\n"
+         "    movq %rcx, %rdx\n"
+         "    movq %r8, %r10\n"
+         "    movq %r9, %r8\n"
+         "    movq 8(%rsp), %r9\n"
+         "    syscall\n"
+         ".globl sv_rtcheck_syscall_return\n"
+         ".hidden sv_rtcheck_syscall_return\n"
+         "sv_rtcheck_syscall_return:\n"
+         "    ret\n"
+         ".size sv_rtcheck_syscall, . - sv_rtcheck_syscall\n");
+
+    struct TrappedSyscall
+    {
+        int number;
+        const char* name;
+    };
+
+    // everything that can block, do I/O or map memory
+    const TrappedSyscall trappedSyscalls[] =
+    {
+        { SYS_read, "read" },                   { SYS_write, "write" },
+        { SYS_readv, "readv" },                 { SYS_writev, "writev" },
+        { SYS_pread64, "pread64" },             { SYS_pwrite64, "pwrite64" },
+        { SYS_open, "open" },                   { SYS_openat, "openat" },
+        { SYS_close, "close" },                 { SYS_ioctl, "ioctl" },
+        { SYS_fsync, "fsync" },                 { SYS_fdatasync, "fdatasync" },
+        { SYS_mmap, "mmap" },                   { SYS_munmap, "munmap" },
+        { SYS_mremap, "mremap" },               { SYS_brk, "brk" },
+        { SYS_nanosleep, "nanosleep" },         { SYS_clock_nanosleep, "clock_nanosleep" },
+        { SYS_sched_yield, "sched_yield" },     { SYS_futex, "futex" },
+        { SYS_poll, "poll" },                   { SYS_ppoll, "ppoll" },
+        { SYS_select, "select" },               { SYS_pselect6, "pselect6" },
+        { SYS_epoll_wait, "epoll_wait" },       { SYS_epoll_pwait, "epoll_pwait" },
+        { SYS_semop, "semop" },                 { SYS_semtimedop, "semtimedop" },
+        { SYS_connect, "connect" },             { SYS_accept, "accept" },
+        { SYS_accept4, "accept4" },             { SYS_sendto, "sendto" },
+        { SYS_recvfrom, "recvfrom" },           { SYS_sendmsg, "sendmsg" },
+        { SYS_recvmsg, "recvmsg" }
+    };
+
+    constexpr int numTrappedSyscalls = (int) (sizeof (trappedSyscalls) / sizeof (trappedSyscalls[0]));
+
+    thread_local bool tFilterInstalled = false;
+
+    const char* getSyscallName (int number)
+    {
+        for (auto& trapped : trappedSyscalls)
+            if (trapped.number == number)
+                return trapped.name;
+
+        return "unknown";
+    }
+
+    // runs on every trapped syscall the thread makes for the rest of its life, inside a scope or not
+    void handleTrappedSyscall (int, siginfo_t* info, void* context)
+    {
+        const int savedErrno = errno;
+        auto* registers = static_cast<ucontext_t*> (context)->uc_mcontext.gregs;
+
+        reportViolation (getSyscallName (info->si_syscall), true);
+
+        registers[REG_RAX] = sv_rtcheck_syscall (info->si_syscall, registers[REG_RDI], registers[REG_RSI], registers[REG_RDX],
+                                                 registers[REG_R10], registers[REG_R8], registers[REG_R9]);
+        errno = savedErrno;
+    }
+
+    // the report itself writes to stderr, so the handler has to be able to run nested, SA_NODEFER lets it
+    void installSyscallHandler()
+    {
+        static std::atomic<bool> installed { false };
+
+        if (installed.exchange (true))
+            return;
+
+        struct sigaction action;
+        memset (&action, 0, sizeof (action));
+        action.sa_sigaction = handleTrappedSyscall;
+        action.sa_flags = SA_SIGINFO | SA_NODEFER;
+        sigemptyset (&action.sa_mask);
+        sigaction (SIGSYS, &action, nullptr);
+    }
+
+    // seccomp filters stay for the lifetime of the thread, so this happens once per thread
+    void installSyscallFilter()
+    {
+        if (tFilterInstalled)
+            return;
+
+        tFilterInstalled = true;
+        installSyscallHandler();
+
+        const auto returnAddress = (unsigned long long) (uintptr_t) sv_rtcheck_syscall_return;
+        const auto ipLow = (unsigned int) (returnAddress & 0xffffffffu);
+        const auto ipHigh = (unsigned int) (returnAddress >> 32);
+
+        // other architectures (x32, i386 compat) pass, then the trampoline passes, then the list traps.
+        // jump offsets count the instructions skipped, the list is laid out as [checks..., allow, trap]
+        sock_filter program[7 + numTrappedSyscalls + 2];
+        int length = 0;
+
+        program[length++] = BPF_STMT (BPF_LD | BPF_W | BPF_ABS, (unsigned int) offsetof (seccomp_data, arch));
+        program[length++] = BPF_JUMP (BPF_JMP | BPF_JEQ | BPF_K, AUDIT_ARCH_X86_64, 0, (unsigned char) (5 + numTrappedSyscalls));
+        program[length++] = BPF_STMT (BPF_LD | BPF_W | BPF_ABS, (unsigned int) offsetof (seccomp_data, instruction_pointer));
+        program[length++] = BPF_JUMP (BPF_JMP | BPF_JEQ | BPF_K, ipLow, 0, 2);
+        program[length++] = BPF_STMT (BPF_LD | BPF_W | BPF_ABS, (unsigned int) offsetof (seccomp_data, instruction_pointer) + 4);
+        program[length++] = BPF_JUMP (BPF_JMP | BPF_JEQ | BPF_K, ipHigh, (unsigned char) (1 + numTrappedSyscalls), 0);
+        program[length++] = BPF_STMT (BPF_LD | BPF_W | BPF_ABS, (unsigned int) offsetof (seccomp_data, nr));
+
+        for (int i = 0; i < numTrappedSyscalls; ++i)
+            program[length++] = BPF_JUMP (BPF_JMP | BPF_JEQ | BPF_K, (unsigned int) trappedSyscalls[i].number,
+                                          (unsigned char) (numTrappedSyscalls - i), 0);
+
+        program[length++] = BPF_STMT (BPF_RET | BPF_K, SECCOMP_RET_ALLOW);
+        program[length++] = BPF_STMT (BPF_RET | BPF_K, SECCOMP_RET_TRAP);
+
+        sock_fprog filter;
+        filter.len = (unsigned short) length;
+        filter.filter = program;
+
+        // without it only the libc hooks are left, which still catch most things, so say so and carry on
+        if (prctl (PR_SET_NO_NEW_PRIVS, 1, 0, 0, 0) != 0 || prctl (PR_SET_SECCOMP, SECCOMP_MODE_FILTER, &filter) != 0)
+        {
+            const char message[] = "real-time check: seccomp isn't available, syscalls made inside libc won't be caught\n";
+            realWrite (STDERR_FILENO, message, sizeof (message) - 1);
+        }
+    }
+   #endif
+}
+
+//==============================================================================
+extern "C"
+{
+    void* __libc_malloc (size_t);
+    void* __libc_calloc (size_t, size_t);
+    void* __libc_realloc (void*, size_t);
+    void* __libc_memalign (size_t, size_t);
+    void __libc_free (void*);
+
+    void* malloc (size_t size)
+    {
+        reportViolation ("malloc");
+        ForwardedCall forwarded;
+        return __libc_malloc (size);
+    }
+
+    void* calloc (size_t num, size_t size)
+    {
+        reportViolation ("calloc");
+        ForwardedCall forwarded;
+        return __libc_calloc (num, size);
+    }
+
+    void* realloc (void* ptr, size_t size)
+    {
+        reportViolation ("realloc");
+        ForwardedCall forwarded;
+        return __libc_realloc (ptr, size);
+    }
+
+    void* aligned_alloc (size_t alignment, size_t size)
+    {
+        reportViolation ("aligned_alloc");
+        ForwardedCall forwarded;
+        return __libc_memalign (alignment, size);
+    }
+
+    void* memalign (size_t alignment, size_t size)
+    {
+        reportViolation ("memalign");
+        ForwardedCall forwarded;
+        return __libc_memalign (alignment, size);
+    }
+
+    int posix_memalign (void** ptr, size_t alignment, size_t size)
+    {
+        reportViolation ("posix_memalign");
+        ForwardedCall forwarded;
+        *ptr = __libc_memalign (alignment, size);
+        return *ptr != nullptr ? 0 : ENOMEM;
+    }
+
+    void free (void* ptr)
+    {
+        if (ptr != nullptr)
+            reportViolation ("free");
+
+        ForwardedCall forwarded;
+        __libc_free (ptr);
+    }
+
+    //==============================================================================
+    ssize_t write (int fd, const void* buffer, size_t count)
+    {
+        reportViolation ("write");
+        resolveAll();
+        ForwardedCall forwarded;
+        return realWrite (fd, buffer, count);
+    }
+
+    ssize_t read (int fd, void* buffer, size_t count)
+    {
+        reportViolation ("read");
+        resolveAll();
+        ForwardedCall forwarded;
+        return realRead (fd, buffer, count);
+    }
+
+    int open (const char* path, int flags, ...)
+    {
+        reportViolation ("open");
+        resolveAll();
+        ForwardedCall forwarded;
+
+        mode_t mode = 0;
+
+        if ((flags & O_CREAT) != 0)
+        {
+            va_list args;
+            va_start (args, flags);
+            mode = (mode_t) va_arg (args, int);
+            va_end (args);
+        }
+
+        return realOpen (path, flags, mode);
+    }
+
+    int openat (int dirfd, const char* path, int flags, ...)
+    {
+        reportViolation ("openat");
+        resolveAll();
+        ForwardedCall forwarded;
+
+        mode_t mode = 0;
+
+        if ((flags & O_CREAT) != 0)
+        {
+            va_list args;
+            va_start (args, flags);
+            mode = (mode_t) va_arg (args, int);
+            va_end (args);
+        }
+
+        return realOpenAt (dirfd, path, flags, mode);
+    }
+
+    int close (int fd)
+    {
+        reportViolation ("close");
+        resolveAll();
+        ForwardedCall forwarded;
+        return realClose (fd);
+    }
+
+    FILE* fopen (const char* path, const char* mode)
+    {
+        reportViolation ("fopen");
+        resolveAll();
+        ForwardedCall forwarded;
+        return realFOpen (path, mode);
+    }
+
+    size_t fwrite (const void* buffer, size_t size, size_t count, FILE* stream)
+    {
+        reportViolation ("fwrite");
+        resolveAll();
+        ForwardedCall forwarded;
+        return realFWrite (buffer, size, count, stream);
+    }
+
+    int fflush (FILE* stream)
+    {
+        reportViolation ("fflush");
+        resolveAll();
+        ForwardedCall forwarded;
+        return realFFlush (stream);
+    }
+
+    int nanosleep (const struct timespec* duration, struct timespec* remaining)
+    {
+        reportViolation ("nanosleep");
+        resolveAll();
+        ForwardedCall forwarded;
+        return realNanosleep (duration, remaining);
+    }
+
+    int usleep (useconds_t microseconds)
+    {
+        reportViolation ("usleep");
+        resolveAll();
+        ForwardedCall forwarded;
+        return realUsleep (microseconds);
+    }
+
+    int sched_yield()
+    {
+        reportViolation ("sched_yield");
+        resolveAll();
+        ForwardedCall forwarded;
+        return realSchedYield();
+    }
+
+    //==============================================================================
+    int pthread_mutex_lock (pthread_mutex_t* mutex)
+    {
+        reportViolation ("pthread_mutex_lock");
+        resolveAll();
+        ForwardedCall forwarded;
+        return realMutexLock (mutex);
+    }
+
+    int pthread_mutex_trylock (pthread_mutex_t* mutex)
+    {
+        reportViolation ("pthread_mutex_trylock");
+        resolveAll();
+        ForwardedCall forwarded;
+        return realMutexTryLock (mutex);
+    }
+
+    int pthread_mutex_timedlock (pthread_mutex_t* mutex, const struct timespec* timeout)
+    {
+        reportViolation ("pthread_mutex_timedlock");
+        resolveAll();
+        ForwardedCall forwarded;
+        return realMutexTimedLock (mutex, timeout);
+    }
+
+    int pthread_mutex_clocklock (pthread_mutex_t* mutex, clockid_t clock, const struct timespec* timeout)
+    {
+        reportViolation ("pthread_mutex_clocklock");
+        resolveAll();
+        ForwardedCall forwarded;
+        return realMutexClockLock != nullptr ? realMutexClockLock (mutex, clock, timeout) : ENOSYS;
+    }
+
+    int pthread_cond_wait (pthread_cond_t* condition, pthread_mutex_t* mutex)
+    {
+        reportViolation ("pthread_cond_wait");
+        resolveAll();
+        ForwardedCall forwarded;
+        return realCondWait (condition, mutex);
+    }
+
+    int pthread_cond_timedwait (pthread_cond_t* condition, pthread_mutex_t* mutex, const struct timespec* timeout)
+    {
+        reportViolation ("pthread_cond_timedwait");
+        resolveAll();
+        ForwardedCall forwarded;
+        return realCondTimedWait (condition, mutex, timeout);
+    }
+
+    // only in glibc 2.30 and later, older ones never call it
+    int pthread_cond_clockwait (pthread_cond_t* condition, pthread_mutex_t* mutex, clockid_t clock, const struct timespec* timeout)
+    {
+        reportViolation ("pthread_cond_clockwait");
+        resolveAll();
+        ForwardedCall forwarded;
+        return realCondClockWait != nullptr ? realCondClockWait (condition, mutex, clock, timeout) : ENOSYS;
+    }
+
+    int pthread_rwlock_rdlock (pthread_rwlock_t* lock)
+    {
+        reportViolation ("pthread_rwlock_rdlock");
+        resolveAll();
+        ForwardedCall forwarded;
+        return realRwLockRdLock (lock);
+    }
+
+    int pthread_rwlock_wrlock (pthread_rwlock_t* lock)
+    {
+        reportViolation ("pthread_rwlock_wrlock");
+        resolveAll();
+        ForwardedCall forwarded;
+        return realRwLockWrLock (lock);
+    }
+
+    int pthread_rwlock_tryrdlock (pthread_rwlock_t* lock)
+    {
+        reportViolation ("pthread_rwlock_tryrdlock");
+        resolveAll();
+        ForwardedCall forwarded;
+        return realRwLockTryRdLock (lock);
+    }
+
+    int pthread_rwlock_trywrlock (pthread_rwlock_t* lock)
+    {
+        reportViolation ("pthread_rwlock_trywrlock");
+        resolveAll();
+        ForwardedCall forwarded;
+        return realRwLockTryWrLock (lock);
+    }
+
+    int pthread_rwlock_timedrdlock (pthread_rwlock_t* lock, const struct timespec* timeout)
+    {
+        reportViolation ("pthread_rwlock_timedrdlock");
+        resolveAll();
+        ForwardedCall forwarded;
+        return realRwLockTimedRdLock (lock, timeout);
+    }
+
+    int pthread_rwlock_timedwrlock (pthread_rwlock_t* lock, const struct timespec* timeout)
+    {
+        reportViolation ("pthread_rwlock_timedwrlock");
+        resolveAll();
+        ForwardedCall forwarded;
+        return realRwLockTimedWrLock (lock, timeout);
+    }
+
+    int sem_wait (sem_t* semaphore)
+    {
+        reportViolation ("sem_wait");
+        resolveAll();
+        ForwardedCall forwarded;
+        return realSemWait (semaphore);
+    }
+
+    int sem_trywait (sem_t* semaphore)
+    {
+        reportViolation ("sem_trywait");
+        resolveAll();
+        ForwardedCall forwarded;
+        return realSemTryWait (semaphore);
+    }
+
+    int sem_timedwait (sem_t* semaphore, const struct timespec* timeout)
+    {
+        reportViolation ("sem_timedwait");
+        resolveAll();
+        ForwardedCall forwarded;
+        return realSemTimedWait (semaphore, timeout);
+    }
+
+    int sem_clockwait (sem_t* semaphore, clockid_t clock, const struct timespec* timeout)
+    {
+        reportViolation ("sem_clockwait");
+        resolveAll();
+        ForwardedCall forwarded;
+
+        if (realSemClockWait == nullptr)
+        {
+            errno = ENOSYS;
+            return -1;
+        }
+
+        return realSemClockWait (semaphore, clock, timeout);
+    }
+
+    //==============================================================================
+    // stdout is buffered, so once it's warmed up printf never reaches write() until the buffer fills.
+    // everything funnels into the real vfprintf, including the _chk variants _FORTIFY_SOURCE turns printf into
+    int vfprintf (FILE* stream, const char* format, va_list args)
+    {
+        reportViolation ("vfprintf");
+        resolveAll();
+        ForwardedCall forwarded;
+        return realVFPrintf (stream, format, args);
+    }
+
+    int vprintf (const char* format, va_list args)
+    {
+        reportViolation ("vprintf");
+        resolveAll();
+        ForwardedCall forwarded;
+        return realVFPrintf (stdout, format, args);
+    }
+
+    int fprintf (FILE* stream, const char* format, ...)
+    {
+        reportViolation ("fprintf");
+        resolveAll();
+        ForwardedCall forwarded;
+
+        va_list args;
+        va_start (args, format);
+        int result = realVFPrintf (stream, format, args);
+        va_end (args);
+        return result;
+    }
+
+    int printf (const char* format, ...)
+    {
+        reportViolation ("printf");
+        resolveAll();
+        ForwardedCall forwarded;
+
+        va_list args;
+        va_start (args, format);
+        int result = realVFPrintf (stdout, format, args);
+        va_end (args);
+        return result;
+    }
+
+    int __vfprintf_chk (FILE* stream, int, const char* format, va_list args)
+    {
+        reportViolation ("vfprintf");
+        resolveAll();
+        ForwardedCall forwarded;
+        return realVFPrintf (stream, format, args);
+    }
+
+    int __vprintf_chk (int, const char* format, va_list args)
+    {
+        reportViolation ("vprintf");
+        resolveAll();
+        ForwardedCall forwarded;
+        return realVFPrintf (stdout, format, args);
+    }
+
+    int __fprintf_chk (FILE* stream, int, const char* format, ...)
+    {
+        reportViolation ("fprintf");
+        resolveAll();
+        ForwardedCall forwarded;
+
+        va_list args;
+        va_start (args, format);
+        int result = realVFPrintf (stream, format, args);
+        va_end (args);
+        return result;
+    }
+
+    int __printf_chk (int, const char* format, ...)
+    {
+        reportViolation ("printf");
+        resolveAll();
+        ForwardedCall forwarded;
+
+        va_list args;
+        va_start (args, format);
+        int result = realVFPrintf (stdout, format, args);
+        va_end (args);
+        return result;
+    }
+
+    int puts (const char* text)
+    {
+        reportViolation ("puts");
+        resolveAll();
+        ForwardedCall forwarded;
+        return realPuts (text);
+    }
+
+    int fputs (const char* text, FILE* stream)
+    {
+        reportViolation ("fputs");
+        resolveAll();
+        ForwardedCall forwarded;
+        return realFPuts (text, stream);
+    }
+
+    int putchar (int character)
+    {
+        reportViolation ("putchar");
+        resolveAll();
+        ForwardedCall forwarded;
+        return realPutChar (character);
+    }
+
+    int fputc (int character, FILE* stream)
+    {
+        reportViolation ("fputc");
+        resolveAll();
+        ForwardedCall forwarded;
+        return realFPutC (character, stream);
+    }
+
+    int putc (int character, FILE* stream)
+    {
+        reportViolation ("putc");
+        resolveAll();
+        ForwardedCall forwarded;
+        return realPutC (character, stream);
+    }
+
+    //==============================================================================
+    // the raw syscall() entry point, the seccomp filter catches the ones that don't come through here
+    long syscall (long number, ...)
+    {
+        reportViolation ("syscall");
+        resolveAll();
+        ForwardedCall forwarded;
+
+        va_list args;
+        va_start (args, number);
+        long arg1 = va_arg (args, long), arg2 = va_arg (args, long), arg3 = va_arg (args, long);
+        long arg4 = va_arg (args, long), arg5 = va_arg (args, long), arg6 = va_arg (args, long);
+        va_end (args);
+
+        return realSyscall (number, arg1, arg2, arg3, arg4, arg5, arg6);
+    }
+}
+
+//==============================================================================
+RealtimeCheck::ScopedAudioThread::ScopedAudioThread()
+    : mWasAudioThread (tIsAudioThread)
+{
+    resolveAll();
+
+   #if SCHROEDERVERB_RTCHECK_SECCOMP
+    installSyscallFilter();
+   #endif
+
+    tIsAudioThread = true;
+}
+
+RealtimeCheck::ScopedAudioThread::~ScopedAudioThread()
+{
+    tIsAudioThread = mWasAudioThread;
+}
+
+bool RealtimeCheck::isSupported()          { return true; }
+int RealtimeCheck::getNumViolations()      { return gNumViolations.load(); }
+void RealtimeCheck::resetViolations()      { gNumViolations.store (0); }
+
+#else
+
+// no hooks on this platform, the scope only exists so callers compile everywhere
+RealtimeCheck::ScopedAudioThread::ScopedAudioThread() : mWasAudioThread (false) {}
+RealtimeCheck::ScopedAudioThread::~ScopedAudioThread() {}
+
+bool RealtimeCheck::isSupported()          { return false; }
+int RealtimeCheck::getNumViolations()      { return 0; }
+void RealtimeCheck::resetViolations()      {}
+
+#endif
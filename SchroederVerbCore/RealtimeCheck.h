@@ -0,0 +1,50 @@
+/*
+  ==============================================================================
+
+    RealtimeCheck.h
+
+    Instrumentation that catches real-time violations on the audio thread.
+    Only built with SCHROEDERVERB_RTCHECK (cmake -DSCHROEDERVERB_RTCHECK=ON).
+
+    While a ScopedAudioThread is alive on a thread, every heap allocation or
+    free, mutex, rwlock or semaphore lock, condition wait (timed or not),
+    sleep, printf-style or file I/O call and raw syscall() made on that thread
+    is counted and reported on stderr with a stack trace. The hooks interpose
+    the libc functions, so they need Linux with glibc, elsewhere the scope is
+    a no-op.
+
+    On x86_64 a seccomp filter also traps the blocking, I/O and memory
+    mapping syscalls themselves, which catches what libc does internally.
+    The filter can't be taken off again, so once a thread has had a scope
+    those syscalls go through a signal handler for the rest of its life;
+    outside a scope they're passed on unreported, just slower.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+//==============================================================================
+class RealtimeCheck
+{
+public:
+    // marks the calling thread as the audio thread for the lifetime of the object
+    class ScopedAudioThread
+    {
+    public:
+        ScopedAudioThread();
+        ~ScopedAudioThread();
+
+    private:
+        bool mWasAudioThread;
+
+        ScopedAudioThread (const ScopedAudioThread&) = delete;
+        ScopedAudioThread& operator= (const ScopedAudioThread&) = delete;
+    };
+
+    // true when the hooks are compiled in for this platform
+    static bool isSupported();
+
+    static int getNumViolations();
+    static void resetViolations();
+};
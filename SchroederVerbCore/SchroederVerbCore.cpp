@@ -0,0 +1,1067 @@
+/*
+  ==============================================================================
+
+    SchroederVerbCore.cpp
+
+  ==============================================================================
+*/
+
+#include "SchroederVerbCore.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+
+#if defined (__x86_64__) || defined (__i386__) || defined (_M_X64) || defined (_M_IX86)
+ #include <immintrin.h>
+ #define SCHROEDERVERB_PAUSE() _mm_pause()
+#elif defined (__aarch64__) || defined (__arm__)
+ #define SCHROEDERVERB_PAUSE() __asm__ __volatile__ ("yield")
+#else
+ #define SCHROEDERVERB_PAUSE()
+#endif
+
+#if defined (__APPLE__)
+ #include <mach/mach.h>
+ #include <mach/mach_time.h>
+ #include <mach/thread_policy.h>
+ #include <pthread.h>
+#elif defined (__linux__)
+ #include <pthread.h>
+ #include <sched.h>
+#elif defined (_WIN32)
+ #ifndef WIN32_LEAN_AND_MEAN
+  #define WIN32_LEAN_AND_MEAN
+ #endif
+ #ifndef NOMINMAX
+  #define NOMINMAX
+ #endif
+ #include <windows.h>
+#endif
+
+//==============================================================================
+namespace
+{
+    // an idle worker spins this long for the next block before it starts yielding and then napping.
+    // after a few thousand naps (a few tenths of a second) the host has stopped calling us, so the naps get long.
+    // a worker that oversleeps costs nothing but time on the audio thread, which runs the slices nobody claimed
+    const int workerSpins = 2000;
+    const int workerYields = 100;
+    const int workerNaps = 4000;
+
+    // SCHED_FIFO priority of the workers on Linux, mid range. a preempted real-time thread gets pushed to another
+    // core right away instead of waiting for its time slice, which is what keeps the audio thread from waiting on it
+    const int workerPriority = 50;
+
+    // finishLineJob() waits as long as it takes, for everyone but the audio thread
+    const auto noDeadline = std::chrono::steady_clock::time_point::max();
+
+    void makeRealtime (std::thread& thread, double blockSeconds)
+    {
+        // the workers do the audio thread's work, so they get the same kind of scheduling. where that isn't allowed
+        // (no rtkit or RLIMIT_RTPRIO on Linux) they stay ordinary threads and a late block costs a short fade
+       #if defined (__APPLE__)
+        // a time constraint thread like the Core Audio ones: up to WORKERWAITFRACTION of every block, due within it
+        mach_timebase_info_data_t timebase;
+        mach_timebase_info (&timebase);
+        const double ticksPerSecond = 1.0e9 * (double) timebase.denom / (double) timebase.numer;
+
+        thread_time_constraint_policy_data_t policy;
+        policy.period = (uint32_t) (blockSeconds * ticksPerSecond);
+        policy.computation = (uint32_t) (WORKERWAITFRACTION * blockSeconds * ticksPerSecond);
+        policy.constraint = policy.period;
+        policy.preemptible = true;
+        thread_policy_set (pthread_mach_thread_np (thread.native_handle()), THREAD_TIME_CONSTRAINT_POLICY,
+                           (thread_policy_t) &policy, THREAD_TIME_CONSTRAINT_POLICY_COUNT);
+       #elif defined (__linux__)
+        sched_param param {};
+        param.sched_priority = workerPriority;
+        pthread_setschedparam (thread.native_handle(), SCHED_FIFO, &param);
+        (void) blockSeconds;
+       #elif defined (_WIN32)
+        SetThreadPriority ((HANDLE) thread.native_handle(), THREAD_PRIORITY_TIME_CRITICAL);
+        (void) blockSeconds;
+       #else
+        (void) thread;
+        (void) blockSeconds;
+       #endif
+    }
+}
+
+//==============================================================================
+void SchroederVerbCore::DelayLine::setSize (int numChannels, int numSamples)
+{
+    mNumChannels = numChannels;
+    mSize = std::max (1, numSamples);
+    mData.assign ((size_t) mNumChannels * (size_t) mSize, 0.0f);
+    mWriteIdx = 0;
+}
+
+void SchroederVerbCore::DelayLine::clear()
+{
+    std::fill (mData.begin(), mData.end(), 0.0f);
+    mWriteIdx = 0;
+}
+
+void SchroederVerbCore::DelayLine::write (int channel, const float* source, int numSamples)
+{
+    // copy in up to two pieces, before and after the wrap point
+    float* data = getChannel (channel);
+    int first = std::min (numSamples, mSize - mWriteIdx);
+    std::memcpy (data + mWriteIdx, source, sizeof (float) * (size_t) first);
+    std::memcpy (data, source + first, sizeof (float) * (size_t) (numSamples - first));
+}
+
+void SchroederVerbCore::DelayLine::writeZeros (int channel, int numSamples)
+{
+    float* data = getChannel (channel);
+    int first = std::min (numSamples, mSize - mWriteIdx);
+    std::fill (data + mWriteIdx, data + mWriteIdx + first, 0.0f);
+    std::fill (data, data + (numSamples - first), 0.0f);
+}
+
+void SchroederVerbCore::DelayLine::clearBehind (int channel, int numSamples)
+{
+    // zero the numSamples most recently written, i.e. everything a read with delay < numSamples can reach
+    float* data = getChannel (channel);
+    numSamples = std::min (numSamples, mSize);
+    int start = mWriteIdx - numSamples;
+
+    if (start >= 0)
+    {
+        std::fill (data + start, data + mWriteIdx, 0.0f);
+    }
+    else
+    {
+        std::fill (data + start + mSize, data + mSize, 0.0f);
+        std::fill (data, data + mWriteIdx, 0.0f);
+    }
+}
+
+void SchroederVerbCore::DelayLine::read (int channel, int delay, float* dest, int numSamples) const
+{
+    const float* data = getChannel (channel);
+    int readIdx = (mWriteIdx - delay) % mSize;
+    if (readIdx < 0)
+        readIdx += mSize;
+
+    int first = std::min (numSamples, mSize - readIdx);
+    std::memcpy (dest, data + readIdx, sizeof (float) * (size_t) first);
+    std::memcpy (dest + first, data, sizeof (float) * (size_t) (numSamples - first));
+}
+
+void SchroederVerbCore::DelayLine::advanceWriteIdx (int numSamples)
+{
+    mWriteIdx = (mWriteIdx + numSamples) % mSize;
+}
+
+//==============================================================================
+SchroederVerbCore::SchroederVerbCore()
+    : mSampleRate (44100.0), mMaxBlockSize (512), mKernels (&SchroederVerbKernels::get (SchroederVerbKernels::scalar))
+{
+    // tap OutA and OutD for the stereo channels we send back to the host
+    mMMOutLeft = 0;
+    mMMOutRight = 3;
+
+    for (int stage = 0; stage < NUMER; ++stage)
+        mPendingERDelaysMs[stage].store (mERDelaysMs[stage]);
+
+    for (int channel = 0; channel < NUMFBCF; ++channel)
+    {
+        mPendingCombDelaysMs[channel].store (mCombFilterDelaysMs[channel]);
+        mPendingCombFeedbacks[channel].store (mCombFilterFeedbacks[channel]);
+    }
+
+    mPendingMatrixOut[0].store (mMMOutLeft);
+    mPendingMatrixOut[1].store (mMMOutRight);
+    applyParameters (true);
+
+    for (int line = 0; line < MAXLINES; ++line)
+    {
+        mCombWeights[line] = 1.0f;
+        mCombTargets[line] = 1.0f;
+        mCombRunning[line] = true;
+    }
+}
+
+SchroederVerbCore::~SchroederVerbCore()
+{
+    stopWorkers();
+}
+
+void SchroederVerbCore::prepare (double sampleRate, int maxBlockSize)
+{
+    // the workers read everything below, so they go first and come back at the end
+    stopWorkers();
+
+    // workers only pay off when they get a core the audio thread isn't using.
+    // with none to spare the lines run on the calling thread
+    int spareCores = std::max (0, (int) std::thread::hardware_concurrency() - 1);
+    int numThreads = std::min (mRequestedThreads, spareCores);
+
+    mSampleRate = sampleRate;
+    mMaxBlockSize = std::max (1, maxBlockSize);
+    mNumLines = mRequestedLines;
+    mNumThreads = numThreads;
+    mNumSlices = std::max (1, numThreads);
+    mGroupGain = 1.0f / std::sqrt ((float) (mNumLines / NUMFBCF));
+
+    // look at the CPU once here and bind the widest kernels it supports (or the forced variant)
+    mKernels = &SchroederVerbKernels::get (mRequestedKernelVariant);
+
+    // we have mNumLines feedback comb filters that need to be combined with direct input
+    // let's make these buffers quite long in duration so we can have long tails
+    int ringSize = (int) (DELAYLINESECONDS * mSampleRate) + mMaxBlockSize;
+    // ...unless there are dozens of them, their delays stay well below a second anyway
+    int linesRingSize = mNumLines > NUMFBCF ? (int) (LARGENETWORKSECONDS * mSampleRate) + mMaxBlockSize : ringSize;
+    mFBCFRingBuf.setSize (mNumLines, linesRingSize);
+    // these are for the delays on the right channel of the early reflection chain
+    // they should be the same duration as the ring buffer
+    mERDelayRingBuf.setSize (NUMER, ringSize);
+
+    mERBuf.assign (2 * 2 * (size_t) mMaxBlockSize, 0.0f);
+    mDelayBlockBuf.assign ((size_t) mNumSlices * (size_t) mMaxBlockSize, 0.0f);
+    mPartialBuf.assign ((size_t) mNumSlices * NUMFBCF * (size_t) mMaxBlockSize, 0.0f);
+    mMMBuf.assign (NUMFBCF * (size_t) mMaxBlockSize, 0.0f);
+    mInterleaveBuf.assign (2 * (size_t) mMaxBlockSize, 0.0f);
+    mERShortBuf.assign (2 * (size_t) mMaxBlockSize, 0.0f);
+    mERDiffBuf.assign ((size_t) mMaxBlockSize, 0.0f);
+    mLatencyBuf.assign (2 * 2 * (size_t) mMaxBlockSize, 0.0f);
+
+    // the delays in samples depend on the rate and the delay line sizes, so they're all worked out again
+    mParametersPending.store (false);
+    applyParameters (true);
+
+    mClearGainStep = 1.0f / std::max (1.0f, (float) (CLEARFADEMS / 1000.0 * mSampleRate));
+    mQualityFadeStep = 1.0f / std::max (1.0f, (float) (QUALITYFADEMS / 1000.0 * mSampleRate));
+    reset();
+    resetQualityState();
+
+    if (numThreads > 0)
+        startWorkers (numThreads);
+}
+
+void SchroederVerbCore::release()
+{
+    stopWorkers();
+}
+
+void SchroederVerbCore::reset()
+{
+    // let the workers finish the block they're on before pulling the delay lines out from under them.
+    // a block still waiting for its combs is covered by the clear below
+    finishLineJob (noDeadline);
+    mDeferredSize = 0;
+    mERSet = 0;
+    mJobERSet = 0;
+
+    mFBCFRingBuf.clear();
+    mERDelayRingBuf.clear();
+    std::fill (mERBuf.begin(), mERBuf.end(), 0.0f);
+    std::fill (mDelayBlockBuf.begin(), mDelayBlockBuf.end(), 0.0f);
+    std::fill (mPartialBuf.begin(), mPartialBuf.end(), 0.0f);
+    std::fill (mMMBuf.begin(), mMMBuf.end(), 0.0f);
+    resetLatencyBuf();
+
+    // anything pending is covered by the clear above
+    mClearRequested.store (false);
+    mClearState = clearIdle;
+    mClearGain = 1.0f;
+}
+
+void SchroederVerbCore::requestClear()
+{
+    // the audio thread picks this up at the start of the next block
+    mClearRequested.store (true);
+}
+
+void SchroederVerbCore::setQualityMode (int mode)
+{
+    mPinnedQualityMode.store (std::min (std::max (mode, (int) qualityAuto), numQualityModes - 1));
+}
+
+void SchroederVerbCore::setLargeNetwork (int numLines, int numThreads)
+{
+    numLines = std::min (std::max (numLines, NUMFBCF), MAXLINES);
+    mRequestedLines = numLines - numLines % NUMFBCF;
+    // more threads than lines would leave some of them with nothing to do
+    mRequestedThreads = std::min (std::max (numThreads, 0), std::min (MAXWORKERTHREADS, mRequestedLines));
+}
+
+//==============================================================================
+int SchroederVerbCore::msToSamps (double ms, const DelayLine& ring) const
+{
+    int samps = (int) std::lround (ms / 1000.0 * mSampleRate);
+
+    // never read further back than the delay line holds. the comb ring is shorter than the ER ring in large network mode
+    int maxSamps = ring.getSize() - mMaxBlockSize;
+    return std::max (0, maxSamps > 0 ? std::min (samps, maxSamps) : samps);
+}
+
+void SchroederVerbCore::updateLines (int comb)
+{
+    // line comb + n * NUMFBCF stretches the comb's delay by 1 + n * LARGENETWORKSPREAD. raising the feedback to the
+    // same power keeps the gain per second, so every line grown out of a comb decays at the comb's rate
+    for (int line = comb, group = 0; line < MAXLINES; line += NUMFBCF, ++group)
+    {
+        double stretch = 1.0 + LARGENETWORKSPREAD * group;
+        double feedback = mCombFilterFeedbacks[comb] / 100.0;
+
+        mFBCFDelSamps[line] = msToSamps (mCombFilterDelaysMs[comb] * stretch, mFBCFRingBuf);
+        mFBCFFdbkCoeffs[line] = (float) std::copysign (std::pow (std::abs (feedback), stretch), feedback);
+    }
+}
+
+void SchroederVerbCore::applyParameters (bool recalculateAll)
+{
+    // only what changed is worked out again, updateLines() is a few dozen pow() calls per comb
+    for (int stage = 0; stage < NUMER; ++stage)
+    {
+        double delayMs = mPendingERDelaysMs[stage].load();
+
+        if (recalculateAll || delayMs != mERDelaysMs[stage])
+        {
+            mERDelaysMs[stage] = delayMs;
+            mERDelSamps[stage] = msToSamps (delayMs, mERDelayRingBuf);
+        }
+    }
+
+    for (int comb = 0; comb < NUMFBCF; ++comb)
+    {
+        double delayMs = mPendingCombDelaysMs[comb].load();
+        double feedback = mPendingCombFeedbacks[comb].load();
+
+        if (recalculateAll || delayMs != mCombFilterDelaysMs[comb] || feedback != mCombFilterFeedbacks[comb])
+        {
+            mCombFilterDelaysMs[comb] = delayMs;
+            mCombFilterFeedbacks[comb] = feedback;
+            updateLines (comb);
+        }
+    }
+
+    mMMOutLeft = mPendingMatrixOut[0].load();
+    mMMOutRight = mPendingMatrixOut[1].load();
+}
+
+void SchroederVerbCore::setParameter (Parameter parameter, int index, double value)
+{
+    // the audio thread and the workers read the applied values while a block is running,
+    // so this only leaves the new value for the next processBlock() to pick up
+    switch (parameter)
+    {
+        case erDelayMs:
+            mPendingERDelaysMs[std::min (std::max (index, 0), NUMER - 1)].store (value);
+            break;
+
+        case combDelayMs:
+            mPendingCombDelaysMs[std::min (std::max (index, 0), NUMFBCF - 1)].store (value);
+            break;
+
+        case combFeedback:
+            // feedback is stored as a percentage, same as the defaults in mCombFilterFeedbacks
+            mPendingCombFeedbacks[std::min (std::max (index, 0), NUMFBCF - 1)].store (value);
+            break;
+
+        case matrixOut:
+            mPendingMatrixOut[index == 0 ? 0 : 1].store (std::min (std::max ((int) std::lround (value), 0), 3));
+            break;
+
+        default:
+            return;
+    }
+
+    mParametersPending.store (true);
+}
+
+double SchroederVerbCore::getParameter (Parameter parameter, int index) const
+{
+    switch (parameter)
+    {
+        case erDelayMs:      return mPendingERDelaysMs[std::min (std::max (index, 0), NUMER - 1)].load();
+        case combDelayMs:    return mPendingCombDelaysMs[std::min (std::max (index, 0), NUMFBCF - 1)].load();
+        case combFeedback:   return mPendingCombFeedbacks[std::min (std::max (index, 0), NUMFBCF - 1)].load();
+        case matrixOut:      return mPendingMatrixOut[index == 0 ? 0 : 1].load();
+        default:             return 0.0;
+    }
+}
+
+//==============================================================================
+void SchroederVerbCore::processPlanar (const float* const* inputs, float* const* outputs, int numChannels, int numSamples)
+{
+    // foreign hosts can hand us empty buffers (and null pointers with them), there's nothing to do for those
+    if (numChannels <= 0 || numSamples <= 0)
+        return;
+
+    // hosts can hand us more than mMaxBlockSize, so work through it in chunks we have buffers for
+    for (int pos = 0; pos < numSamples; pos += mMaxBlockSize)
+    {
+        int bufSize = std::min (mMaxBlockSize, numSamples - pos);
+
+        const float* in[2] = { inputs[0] + pos, numChannels > 1 ? inputs[1] + pos : nullptr };
+        float* out[2] = { outputs[0] + pos, numChannels > 1 ? outputs[1] + pos : nullptr };
+
+        processBlock (in, out, std::min (numChannels, 2), bufSize);
+
+        // the reverb only uses the first two channels, anything else is passed through
+        for (int channel = 2; channel < numChannels; ++channel)
+            mKernels->scale (inputs[channel] + pos, outputs[channel] + pos, bufSize, (float) OUTPUTGAIN);
+    }
+}
+
+void SchroederVerbCore::processInterleaved (const float* input, float* output, int numChannels, int numSamples)
+{
+    if (numChannels <= 0 || numSamples <= 0)
+        return;
+
+    float* scratch[2] = { mInterleaveBuf.data(), mInterleaveBuf.data() + mMaxBlockSize };
+    int numReverbChannels = std::min (numChannels, 2);
+
+    for (int pos = 0; pos < numSamples; pos += mMaxBlockSize)
+    {
+        int bufSize = std::min (mMaxBlockSize, numSamples - pos);
+        const float* in = input + (size_t) pos * (size_t) numChannels;
+        float* out = output + (size_t) pos * (size_t) numChannels;
+
+        for (int channel = 0; channel < numReverbChannels; ++channel)
+            for (int sample = 0; sample < bufSize; ++sample)
+                scratch[channel][sample] = in[sample * numChannels + channel];
+
+        processBlock (scratch, scratch, numReverbChannels, bufSize);
+
+        for (int sample = 0; sample < bufSize; ++sample)
+        {
+            for (int channel = 0; channel < numReverbChannels; ++channel)
+                out[sample * numChannels + channel] = scratch[channel][sample];
+
+            for (int channel = numReverbChannels; channel < numChannels; ++channel)
+                out[sample * numChannels + channel] = in[sample * numChannels + channel] * (float) OUTPUTGAIN;
+        }
+    }
+}
+
+void SchroederVerbCore::processBlock (const float* const* inputs, float* const* outputs, int numChannels, int bufSize)
+{
+    auto start = std::chrono::steady_clock::now();
+    auto deadline = start + std::chrono::duration_cast<std::chrono::steady_clock::duration> (
+                                std::chrono::duration<double> (WORKERWAITFRACTION * bufSize / mSampleRate));
+
+    // wait for the workers to get through the previous block, and the one before if that had to wait for them.
+    // once they're done this thread owns the delay lines again
+    bool caughtUp = finishLineJob (deadline);
+
+    if (caughtUp && mDeferredSize > 0)
+    {
+        startLineJob (mDeferredSize);
+        mDeferredSize = 0;
+        caughtUp = finishLineJob (deadline);
+    }
+
+    if (! caughtUp && mDeferredSize > 0 && numChannels > 1)
+    {
+        // still a worker inside its slice two blocks on, it must have lost its core for a while. both ER sets are
+        // taken, so this block's input has nowhere to go. the wet signal already faded out with the block before
+        for (int channel = 0; channel < numChannels; ++channel)
+            std::fill (outputs[channel], outputs[channel] + bufSize, 0.0f);
+
+        updateGovernor (std::chrono::duration<double> (std::chrono::steady_clock::now() - start).count(), bufSize);
+        return;
+    }
+
+    if (caughtUp)
+    {
+        // and with nobody else reading them, parameter changes can go in
+        if (mParametersPending.exchange (false))
+            applyParameters (false);
+
+        // a pinned mode wins, offline there's no deadline so stay at full quality, otherwise follow the governor
+        int pinned = mPinnedQualityMode.load();
+        int mode = pinned != qualityAuto ? pinned : (mIsRealtime.load() ? mAutoQualityMode : (int) qualityFull);
+
+        if (mode != mQualityMode.load())
+            applyQualityMode (mode);
+    }
+
+    renderBlock (inputs, outputs, numChannels, bufSize);
+
+    updateGovernor (std::chrono::duration<double> (std::chrono::steady_clock::now() - start).count(), bufSize);
+}
+
+void SchroederVerbCore::renderBlock (const float* const* inputs, float* const* outputs, int numChannels, int bufSize)
+{
+    if (mClearState == clearIdle && mClearRequested.exchange (false))
+        mClearState = clearFadingOut;
+
+    // while zeroing the delay lines we don't run the reverb at all, the output is silent.
+    // the workers may still be on the last block before the fade ended, then the zeroing waits for them
+    if (mClearState == clearZeroing)
+    {
+        for (int channel = 0; channel < numChannels; ++channel)
+            std::fill (outputs[channel], outputs[channel] + bufSize, 0.0f);
+
+        if (! mJobInFlight && doZeroingChunks())
+        {
+            std::fill (mERBuf.begin(), mERBuf.end(), 0.0f);
+            std::fill (mDelayBlockBuf.begin(), mDelayBlockBuf.end(), 0.0f);
+            std::fill (mPartialBuf.begin(), mPartialBuf.end(), 0.0f);
+            std::fill (mMMBuf.begin(), mMMBuf.end(), 0.0f);
+            resetLatencyBuf();
+            mClearState = clearFadingIn;
+        }
+        return;
+    }
+
+    if (numChannels > 1)
+    {
+        // do early reflections
+        doEarlyReflections (inputs[0], inputs[1], bufSize);
+
+        if (mNumThreads == 0)
+        {
+            // do feedback comb filters
+            doFeedbackCombFilters (0, bufSize);
+
+            // now do the mixing matrix DSP
+            doMixingMatrix (bufSize);
+
+            // tap the selected mixing matrix outputs for the stereo channels, reduced to 40% gain
+            mKernels->scale (getMMBuf (mMMOutLeft), outputs[0], bufSize, (float) OUTPUTGAIN);
+            mKernels->scale (getMMBuf (mMMOutRight), outputs[1], bufSize, (float) OUTPUTGAIN);
+        }
+        else if (! mJobInFlight)
+        {
+            // hand this block's combs to the workers, what goes out now is what they made of the blocks before
+            startLineJob (bufSize);
+
+            // after release() there's nobody to hand them to, run them right away but keep the latency
+            if (mWorkers.empty())
+                finishLineJob (noDeadline);
+
+            readLatencyBuf (outputs, bufSize);
+        }
+        else
+        {
+            // the workers are still on the block before, this one's combs run once they're through (see processBlock()).
+            // nothing of it has come out of them yet, so the wet signal fades out from where it was, and as much of what
+            // they deliver next is skipped so the rest still goes out a block late
+            mDeferredSize = bufSize;
+            mLatencySkip += bufSize;
+
+            for (int channel = 0; channel < 2; ++channel)
+            {
+                std::fill (outputs[channel], outputs[channel] + bufSize, mLastWet[channel]);
+                mKernels->applyRamp (outputs[channel], bufSize, mWetGain, -mWetGain / (float) bufSize);
+            }
+
+            mWetGain = 0.0f;
+        }
+    }
+    else if (numChannels == 1)
+    {
+        mKernels->scale (inputs[0], outputs[0], bufSize, (float) OUTPUTGAIN);
+    }
+
+    if (mClearState == clearFadingOut)
+    {
+        mClearGainStep = -std::abs (mClearGainStep);
+        applyClearFade (outputs, numChannels, bufSize);
+
+        if (mClearGain <= 0.0f)
+        {
+            beginZeroing();
+            mClearState = clearZeroing;
+        }
+    }
+    else if (mClearState == clearFadingIn)
+    {
+        mClearGainStep = std::abs (mClearGainStep);
+        applyClearFade (outputs, numChannels, bufSize);
+
+        if (mClearGain >= 1.0f)
+            mClearState = clearIdle;
+    }
+
+    // we need to advance both of the delay line write indices manually here.
+    // the workers still use the comb write index, finishLineJob() advances that one once they're done
+    if (mNumThreads == 0)
+        mFBCFRingBuf.advanceWriteIdx (bufSize);
+
+    mERDelayRingBuf.advanceWriteIdx (bufSize);
+}
+
+void SchroederVerbCore::doEarlyReflections (const float* left, const float* right, int bufSize)
+{
+    // create early reflection simulation by mixing/delaying the left/right channels
+    // into the set the workers aren't reading
+    float* lErBufPtr = getERBuf (mERSet, 0);
+    float* rErBufPtr = getERBuf (mERSet, 1);
+    float* diff = mERDiffBuf.data();
+
+    // in qualityEconomy the chain stops after QUALITYECONOMYERSTAGES. while switching we run the whole chain
+    // and crossfade between the output of the short chain and the full one
+    const bool runFullChain = mERFullTarget > 0.0f || mERFullWeight > 0.0f;
+    const bool crossfading = runFullChain && ! (mERFullWeight == 1.0f && mERFullTarget == 1.0f);
+    const int numStages = runFullChain ? NUMER : QUALITYECONOMYERSTAGES;
+
+    for (int stage = 0; stage < numStages; ++stage)
+    {
+        // the first stage mixes L+R inputs into channel 0 of ER buf at reduced gain, later stages accumulate
+        // channel 1 into channel 0. either way the difference goes into this stage of the ER delay line
+        if (stage == 0)
+            mKernels->erInput (left, right, lErBufPtr, diff, bufSize, (float) APGAIN);
+        else
+            mKernels->erStage (lErBufPtr, rErBufPtr, diff, bufSize, (float) APGAIN);
+
+        mERDelayRingBuf.write (stage, diff, bufSize);
+
+        // for right channel, pull a block of delayed audio from the ER delay line into channel 1 of the ER buf
+        mERDelayRingBuf.read (stage, mERDelSamps[stage], rErBufPtr, bufSize);
+
+        if (crossfading && stage == QUALITYECONOMYERSTAGES - 1)
+        {
+            std::copy (lErBufPtr, lErBufPtr + bufSize, getERShortBuf (0));
+            std::copy (rErBufPtr, rErBufPtr + bufSize, getERShortBuf (1));
+        }
+    }
+
+    if (crossfading)
+    {
+        float startWeight = mERFullWeight;
+        mERFullWeight = rampTowards (mERFullWeight, mERFullTarget, mQualityFadeStep * bufSize);
+        float increment = (mERFullWeight - startWeight) / (float) bufSize;
+
+        for (int channel = 0; channel < 2; ++channel)
+        {
+            float* full = getERBuf (mERSet, channel);
+            const float* shortChain = getERShortBuf (channel);
+
+            for (int sample = 0; sample < bufSize; ++sample)
+                full[sample] = shortChain[sample] + (full[sample] - shortChain[sample]) * (startWeight + increment * (float) sample);
+        }
+    }
+}
+
+void SchroederVerbCore::doFeedbackCombFilters (int slice, int bufSize)
+{
+    // runs the comb lines of one slice and sums them per mixing matrix input into that slice's partial buffers.
+    // without workers there's a single slice with every line, otherwise this runs on whichever thread claimed the slice
+    float* block = getDelayBlockBuf (slice);
+    bool summed[NUMFBCF] = {};
+
+    for (int input = 0; input < NUMFBCF; ++input)
+        mDirectGains[slice][input][0] = mDirectGains[slice][input][1] = 0.0f;
+
+    for (int channel = slice * mNumLines / mNumSlices; channel < (slice + 1) * mNumLines / mNumSlices; ++channel)
+    {
+        // combs switched off by the quality governor don't cost anything, they just contribute silence
+        if (! mCombRunning[channel])
+            continue;
+
+        // alternate ER channels to pull from so both ER buffer channels are used equally
+        const float* er = getERBuf (mJobERSet, channel % 2);
+        const float gain = mFBCFFdbkCoeffs[channel];
+
+        // pull bufSize samples from the delay line, reduce the amplitude and add the ER signal
+        mFBCFRingBuf.read (channel, mFBCFDelSamps[channel], block, bufSize);
+        mKernels->combFeedback (block, er, bufSize, gain);
+
+        // throw the mix back into the delay line at the current write position, the write index is advanced later
+        mFBCFRingBuf.write (channel, block, bufSize);
+
+        // the level going into the mixing matrix follows the quality mode, the feedback loop itself is untouched
+        float startWeight = mCombWeights[channel];
+        float endWeight = rampTowards (startWeight, mCombTargets[channel], mQualityFadeStep * bufSize);
+
+        if (startWeight != 1.0f || endWeight != 1.0f)
+            mKernels->applyRamp (block, bufSize, startWeight, (endWeight - startWeight) / (float) bufSize);
+
+        mCombWeights[channel] = endWeight;
+
+        if (mNumLines > NUMFBCF)
+        {
+            // after the merge scales everything by mGroupGain, only the base comb's ER should be left
+            float share = (channel < NUMFBCF ? 1.0f : 0.0f) - mGroupGain;
+            mDirectGains[slice][channel % NUMFBCF][0] += share * startWeight;
+            mDirectGains[slice][channel % NUMFBCF][1] += share * endWeight;
+        }
+
+        if (endWeight == 0.0f && mCombTargets[channel] == 0.0f)
+            mCombRunning[channel] = false;
+
+        // line l feeds mixing matrix input l % NUMFBCF
+        float* partial = getPartialBuf (slice, channel % NUMFBCF);
+
+        if (summed[channel % NUMFBCF])
+            mKernels->accumulate (block, partial, bufSize);
+        else
+            std::copy (block, block + bufSize, partial);
+
+        summed[channel % NUMFBCF] = true;
+    }
+
+    for (int input = 0; input < NUMFBCF; ++input)
+        if (! summed[input])
+            std::fill (getPartialBuf (slice, input), getPartialBuf (slice, input) + bufSize, 0.0f);
+}
+
+void SchroederVerbCore::doMixingMatrix (int bufSize)
+{
+    // merge the slices into the first one's partial sums, those are the matrix inputs
+    for (int input = 0; input < NUMFBCF; ++input)
+    {
+        float* sum = getPartialBuf (0, input);
+
+        for (int slice = 1; slice < mNumSlices; ++slice)
+            mKernels->accumulate (getPartialBuf (slice, input), sum, bufSize);
+
+        if (mNumLines > NUMFBCF)
+        {
+            float startGain = 0.0f, endGain = 0.0f;
+
+            for (int slice = 0; slice < mNumSlices; ++slice)
+            {
+                startGain += mDirectGains[slice][input][0];
+                endGain += mDirectGains[slice][input][1];
+            }
+
+            // the lines' ER set is only written again after the merge
+            float* direct = getDelayBlockBuf (0);
+            const float* er = getERBuf (mJobERSet, input % 2);
+            std::copy (er, er + bufSize, direct);
+            mKernels->applyRamp (direct, bufSize, startGain, (endGain - startGain) / (float) bufSize);
+
+            mKernels->scale (sum, sum, bufSize, mGroupGain);
+            mKernels->accumulate (direct, sum, bufSize);
+        }
+    }
+
+    // OutA: s1+s2, OutB: negation of OutA, OutD: s1-s2, OutC: negation of OutD
+    const float* inputs[NUMFBCF] = { getPartialBuf (0, 0), getPartialBuf (0, 1), getPartialBuf (0, 2), getPartialBuf (0, 3) };
+    float* outputs[NUMFBCF] = { getMMBuf (0), getMMBuf (1), getMMBuf (2), getMMBuf (3) };
+
+    mKernels->mixingMatrix (inputs, outputs, bufSize);
+}
+
+//==============================================================================
+void SchroederVerbCore::startWorkers (int numThreads)
+{
+    // no affinity, the OS knows better than we do which cores the host and other instances are using
+    mStopWorkers.store (false);
+    mNextSlice.store (mNumSlices);
+    unsigned generation = mJobGeneration.load();
+
+    for (int thread = 0; thread < numThreads; ++thread)
+    {
+        mWorkers.emplace_back ([this, generation] { runWorker (generation); });
+        makeRealtime (mWorkers.back(), mMaxBlockSize / mSampleRate);
+    }
+}
+
+void SchroederVerbCore::stopWorkers()
+{
+    // a worker only looks at mStopWorkers while idle, so see the block in flight through first
+    finishLineJob (noDeadline);
+    mStopWorkers.store (true);
+
+    for (auto& worker : mWorkers)
+        worker.join();
+
+    mWorkers.clear();
+}
+
+void SchroederVerbCore::runWorker (unsigned generation)
+{
+    for (;;)
+    {
+        int idle = 0;
+        unsigned current;
+
+        while ((current = mJobGeneration.load (std::memory_order_acquire)) == generation)
+        {
+            if (mStopWorkers.load (std::memory_order_acquire))
+                return;
+
+            // spin through the gap between two blocks, only back off properly when the host has stopped calling
+            if (idle < workerSpins)
+                SCHROEDERVERB_PAUSE();
+            else if (idle < workerSpins + workerYields)
+                std::this_thread::yield();
+            else if (idle < workerSpins + workerYields + workerNaps)
+                std::this_thread::sleep_for (std::chrono::microseconds (50));
+            else
+                std::this_thread::sleep_for (std::chrono::milliseconds (2));
+
+            ++idle;
+        }
+
+        // a late worker may find this job already done (or even the next one published), runSlices() sorts that out
+        generation = current;
+        runSlices();
+    }
+}
+
+void SchroederVerbCore::runSlices()
+{
+    // only a claim below mNumSlices is a slice of the current job, and the acquire on it makes everything that
+    // job reads visible. anything above is left over from a finished job and just means there's nothing to do
+    for (int slice = mNextSlice.fetch_add (1, std::memory_order_acq_rel); slice < mNumSlices;
+         slice = mNextSlice.fetch_add (1, std::memory_order_acq_rel))
+    {
+        doFeedbackCombFilters (slice, mJobSize);
+        mJobsDone.fetch_add (1, std::memory_order_release);
+    }
+}
+
+void SchroederVerbCore::startLineJob (int bufSize)
+{
+    // the release on mNextSlice publishes this block's ER output and everything the combs read to whoever claims
+    // a slice, the generation only wakes the workers up
+    mJobSize = bufSize;
+    mJobERSet = mERSet;
+    mERSet = 1 - mERSet;
+    mJobsDone.store (0, std::memory_order_relaxed);
+    mNextSlice.store (0, std::memory_order_release);
+    mJobGeneration.fetch_add (1, std::memory_order_release);
+    mJobInFlight = true;
+}
+
+bool SchroederVerbCore::finishLineJob (std::chrono::steady_clock::time_point deadline)
+{
+    if (! mJobInFlight)
+        return true;
+
+    // the barrier: normally the workers finished while the host was doing other things and there's nothing to do.
+    // slices nobody has started (a worker is asleep or preempted) are quicker to run here than to wait for
+    runSlices();
+
+    if (mJobsDone.load (std::memory_order_acquire) < mNumSlices)
+    {
+        // what's left is running on a worker. the audio thread spins until its deadline, it may well be sitting on
+        // the very core that worker needs. everyone else can afford to yield until it's done
+        while (mJobsDone.load (std::memory_order_acquire) < mNumSlices)
+        {
+            if (deadline == noDeadline)
+                std::this_thread::yield();
+            else if (std::chrono::steady_clock::now() < deadline)
+                SCHROEDERVERB_PAUSE();
+            else
+                return false;
+        }
+    }
+
+    mJobInFlight = false;
+    mFBCFRingBuf.advanceWriteIdx (mJobSize);
+
+    // merge the slices and queue the stereo taps to go out one block later
+    doMixingMatrix (mJobSize);
+    writeLatencyBuf (mJobSize);
+    return true;
+}
+
+void SchroederVerbCore::writeLatencyBuf (int bufSize)
+{
+    // what a late block faded out instead of playing comes off the front, see renderBlock()
+    const int skip = std::min (mLatencySkip, bufSize);
+    const int numSamples = bufSize - skip;
+    mLatencySkip -= skip;
+
+    const int size = 2 * mMaxBlockSize;
+    const int first = std::min (numSamples, size - mLatencyWriteIdx);
+    const int taps[2] = { mMMOutLeft, mMMOutRight };
+
+    for (int channel = 0; channel < 2; ++channel)
+    {
+        // reduced to 40% gain like the taps without workers
+        const float* tap = getMMBuf (taps[channel]) + skip;
+        mKernels->scale (tap, getLatencyBuf (channel) + mLatencyWriteIdx, first, (float) OUTPUTGAIN);
+        mKernels->scale (tap + first, getLatencyBuf (channel), numSamples - first, (float) OUTPUTGAIN);
+    }
+
+    mLatencyWriteIdx = (mLatencyWriteIdx + numSamples) % size;
+}
+
+void SchroederVerbCore::readLatencyBuf (float* const* outputs, int bufSize)
+{
+    // there are always exactly mMaxBlockSize samples waiting here, so any block size up to that can be served
+    const int size = 2 * mMaxBlockSize;
+    const int first = std::min (bufSize, size - mLatencyReadIdx);
+
+    for (int channel = 0; channel < 2; ++channel)
+    {
+        const float* latency = getLatencyBuf (channel);
+        std::copy (latency + mLatencyReadIdx, latency + mLatencyReadIdx + first, outputs[channel]);
+        std::copy (latency, latency + (bufSize - first), outputs[channel] + first);
+
+        // fade back in after a late block
+        if (mWetGain < 1.0f)
+            mKernels->applyRamp (outputs[channel], bufSize, mWetGain, (1.0f - mWetGain) / (float) bufSize);
+
+        mLastWet[channel] = outputs[channel][bufSize - 1];
+    }
+
+    mWetGain = 1.0f;
+    mLatencyReadIdx = (mLatencyReadIdx + bufSize) % size;
+}
+
+void SchroederVerbCore::resetLatencyBuf()
+{
+    // a block of silence ahead of the first merged block is the latency we report
+    std::fill (mLatencyBuf.begin(), mLatencyBuf.end(), 0.0f);
+    mLatencyReadIdx = 0;
+    mLatencyWriteIdx = mMaxBlockSize;
+    mLatencySkip = 0;
+    mWetGain = 1.0f;
+    mLastWet[0] = mLastWet[1] = 0.0f;
+}
+
+//==============================================================================
+void SchroederVerbCore::beginZeroing()
+{
+    // only the most recent (longest delay + one block) samples of each delay line can ever be read back,
+    // so that's all we need to zero instead of the whole 10 second buffer
+    int maxFBCFDelay = 0;
+    for (int channel = 0; channel < mNumLines; ++channel)
+        maxFBCFDelay = std::max (maxFBCFDelay, mFBCFDelSamps[channel]);
+
+    int maxERDelay = 0;
+    for (int stage = 0; stage < NUMER; ++stage)
+        maxERDelay = std::max (maxERDelay, mERDelSamps[stage]);
+
+    mFBCFSampsToClear = std::min (maxFBCFDelay + mMaxBlockSize, mFBCFRingBuf.getSize());
+    mERSampsToClear = std::min (maxERDelay + mMaxBlockSize, mERDelayRingBuf.getSize());
+}
+
+bool SchroederVerbCore::doZeroingChunks()
+{
+    // write at most CLEARCHUNKSPERBLOCK blocks of silence into each delay line per block.
+    // advancing the write index over the zeros leaves nothing but silence behind it, which is what the reads see
+    for (int chunk = 0; chunk < CLEARCHUNKSPERBLOCK; ++chunk)
+    {
+        if (mFBCFSampsToClear > 0)
+        {
+            int numSamps = std::min (mMaxBlockSize, mFBCFSampsToClear);
+            for (int channel = 0; channel < mNumLines; ++channel)
+                mFBCFRingBuf.writeZeros (channel, numSamps);
+            mFBCFRingBuf.advanceWriteIdx (numSamps);
+            mFBCFSampsToClear -= numSamps;
+        }
+
+        if (mERSampsToClear > 0)
+        {
+            int numSamps = std::min (mMaxBlockSize, mERSampsToClear);
+            for (int stage = 0; stage < NUMER; ++stage)
+                mERDelayRingBuf.writeZeros (stage, numSamps);
+            mERDelayRingBuf.advanceWriteIdx (numSamps);
+            mERSampsToClear -= numSamps;
+        }
+    }
+
+    return mFBCFSampsToClear == 0 && mERSampsToClear == 0;
+}
+
+void SchroederVerbCore::applyClearFade (float* const* outputs, int numChannels, int bufSize)
+{
+    // ramp mClearGain towards 0 (fading out) or 1 (fading in) across this block
+    float startGain = mClearGain;
+    mClearGain = std::min (1.0f, std::max (0.0f, mClearGain + mClearGainStep * bufSize));
+    float increment = (mClearGain - startGain) / (float) bufSize;
+
+    for (int channel = 0; channel < numChannels; ++channel)
+        mKernels->applyRamp (outputs[channel], bufSize, startGain, increment);
+}
+
+//==============================================================================
+float SchroederVerbCore::rampTowards (float value, float target, float amount)
+{
+    return value < target ? std::min (value + amount, target) : std::max (value - amount, target);
+}
+
+void SchroederVerbCore::updateGovernor (double elapsedSeconds, int bufSize)
+{
+    const double deadline = bufSize / mSampleRate;
+    const float load = (float) (elapsedSeconds / deadline);
+
+    // smooth over a handful of blocks so one preempted callback doesn't count as pressure
+    float smoothedLoad = mCpuLoad.load();
+    smoothedLoad += 0.1f * (load - smoothedLoad);
+    mCpuLoad.store (smoothedLoad);
+
+    if (mPinnedQualityMode.load() != qualityAuto || ! mIsRealtime.load())
+    {
+        mSecondsOverBudget = 0.0;
+        mSecondsUnderBudget = 0.0;
+        return;
+    }
+
+    mSecondsOverBudget = smoothedLoad > QUALITYHIGHLOAD ? mSecondsOverBudget + deadline : 0.0;
+    mSecondsUnderBudget = smoothedLoad < QUALITYLOWLOAD ? mSecondsUnderBudget + deadline : 0.0;
+
+    // step down quickly under sustained pressure, but wait a good while before stepping back up
+    if (mSecondsOverBudget >= QUALITYDOWNSECONDS && mAutoQualityMode < numQualityModes - 1)
+    {
+        ++mAutoQualityMode;
+        mSecondsOverBudget = 0.0;
+    }
+    else if (mSecondsUnderBudget >= QUALITYUPSECONDS && mAutoQualityMode > qualityFull)
+    {
+        --mAutoQualityMode;
+        mSecondsUnderBudget = 0.0;
+    }
+}
+
+void SchroederVerbCore::applyQualityMode (int mode)
+{
+    const int numCombs = mode == qualityFull ? NUMFBCF : QUALITYREDUCEDCOMBS;
+
+    // fewer combs means less energy in the tail, so the remaining ones are turned up to keep the level
+    const float level = std::sqrt ((float) NUMFBCF / (float) numCombs);
+
+    for (int channel = 0; channel < mNumLines; ++channel)
+    {
+        // the same combs drop out of every group of NUMFBCF lines, so each mixing matrix input loses the same share
+        bool active = channel % NUMFBCF < numCombs;
+        mCombTargets[channel] = active ? level : 0.0f;
+
+        // a comb coming back has stale audio from when it stopped, zero what it can read before it fades in
+        if (active && ! mCombRunning[channel])
+        {
+            mFBCFRingBuf.clearBehind (channel, mFBCFDelSamps[channel] + mMaxBlockSize);
+            mCombRunning[channel] = true;
+        }
+    }
+
+    const bool fullER = mode != qualityEconomy;
+
+    // same for the ER stages past QUALITYECONOMYERSTAGES when they were stopped
+    if (fullER && mERFullWeight == 0.0f && mERFullTarget == 0.0f)
+        for (int stage = QUALITYECONOMYERSTAGES; stage < NUMER; ++stage)
+            mERDelayRingBuf.clearBehind (stage, mERDelSamps[stage] + mMaxBlockSize);
+
+    mERFullTarget = fullER ? 1.0f : 0.0f;
+    mQualityMode.store (mode);
+}
+
+void SchroederVerbCore::resetQualityState()
+{
+    // start in the pinned mode (or full quality) without any crossfade
+    for (int channel = 0; channel < mNumLines; ++channel)
+        mCombRunning[channel] = true;
+
+    mERFullWeight = 1.0f;
+    mERFullTarget = 1.0f;
+
+    int pinned = mPinnedQualityMode.load();
+    applyQualityMode (pinned != qualityAuto ? pinned : (int) qualityFull);
+
+    for (int channel = 0; channel < mNumLines; ++channel)
+    {
+        mCombWeights[channel] = mCombTargets[channel];
+        mCombRunning[channel] = mCombTargets[channel] > 0.0f;
+    }
+
+    mERFullWeight = mERFullTarget;
+    mAutoQualityMode = qualityFull;
+    mSecondsOverBudget = 0.0;
+    mSecondsUnderBudget = 0.0;
+    mCpuLoad.store (0.0f);
+}
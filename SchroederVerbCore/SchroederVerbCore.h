@@ -0,0 +1,308 @@
+/*
+  ==============================================================================
+
+    SchroederVerbCore.h
+
+    The reverb DSP without any JUCE or atec dependencies, so it can be
+    embedded in other hosts or benchmarked on its own. The plugin's
+    SchroederVerbAudioProcessor is a thin adapter around this class.
+
+    Everything is allocated in prepare(), process*(), setParameter(),
+    requestClear() and reset() never allocate. The optional worker threads
+    of the large network mode are started in prepare() and stopped again in
+    release() or the next prepare().
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+#include "SchroederVerbKernels.h"
+
+#define NUMFBCF 4
+#define NUMER 5
+#define APGAIN 0.7
+#define OUTPUTGAIN 0.4
+#define DELAYLINESECONDS 10.0
+#define CLEARFADEMS 5.0
+#define CLEARCHUNKSPERBLOCK 8
+
+// quality governor: cheaper modes switch in when a block takes more than QUALITYHIGHLOAD of its
+// deadline for QUALITYDOWNSECONDS, and back out after QUALITYUPSECONDS below QUALITYLOWLOAD
+#define QUALITYHIGHLOAD 0.7
+#define QUALITYLOWLOAD 0.35
+#define QUALITYDOWNSECONDS 0.25
+#define QUALITYUPSECONDS 3.0
+#define QUALITYFADEMS 50.0
+#define QUALITYREDUCEDCOMBS 2
+#define QUALITYECONOMYERSTAGES 3
+
+// large network mode: up to MAXLINES comb lines, each further group of NUMFBCF lines has delays LARGENETWORKSPREAD
+// longer than the group before. the comb delay lines only hold LARGENETWORKSECONDS so 64 of them still fit in memory
+#define MAXLINES 64
+#define MAXWORKERTHREADS 8
+#define LARGENETWORKSPREAD 0.0731
+#define LARGENETWORKSECONDS 1.0
+// the audio thread waits at most this fraction of a block for workers that are still inside their slices, after that
+// the block's combs wait for the next one and the wet signal fades out and back in around it
+#define WORKERWAITFRACTION 0.5
+
+//==============================================================================
+class SchroederVerbCore
+{
+public:
+    enum Parameter
+    {
+        erDelayMs,      // index 0..NUMER-1, milliseconds
+        combDelayMs,    // index 0..NUMFBCF-1, milliseconds
+        combFeedback,   // index 0..NUMFBCF-1, percent
+        matrixOut       // index 0 = left, 1 = right, value is the mixing matrix output 0..3 (OutA..OutD)
+    };
+
+    enum QualityMode
+    {
+        qualityAuto = -1,   // only for setQualityMode(), let the governor decide
+        qualityFull,        // all comb lines and NUMER ER stages
+        qualityReduced,     // QUALITYREDUCEDCOMBS of every NUMFBCF comb lines, louder to keep the tail level
+        qualityEconomy,     // reduced combs and only QUALITYECONOMYERSTAGES ER stages
+        numQualityModes
+    };
+
+    SchroederVerbCore();
+    ~SchroederVerbCore();
+
+    // allocates the delay lines and work buffers, call before processing and whenever the rate or block size changes
+    void prepare (double sampleRate, int maxBlockSize);
+
+    // stops the worker threads when the host stops processing, the next prepare() starts them again.
+    // the buffers stay, so processing in between still works with the comb lines on the calling thread
+    void release();
+
+    // process numSamples of audio, inputs and outputs may point to the same memory. no channels or no samples
+    // is a no-op, the pointers aren't touched then.
+    // the reverb needs 2 channels, with fewer channels the input is just passed through at OUTPUTGAIN
+    void processPlanar (const float* const* inputs, float* const* outputs, int numChannels, int numSamples);
+    void processInterleaved (const float* input, float* output, int numChannels, int numSamples);
+
+    // safe to call from any thread, the audio thread picks the new value up at the start of the next block
+    // (after the worker threads are done with the previous one). getParameter() returns the last value set
+    void setParameter (Parameter parameter, int index, double value);
+    double getParameter (Parameter parameter, int index) const;
+
+    // zeroes every delay line immediately, this touches the whole 10 second buffers so keep it off the audio thread
+    void reset();
+
+    // safe to call from any thread, the audio thread fades out and clears the delay lines over the next few blocks
+    void requestClear();
+
+    // pin a QualityMode (e.g. for deterministic offline renders) or hand it back to the governor with qualityAuto.
+    // safe to call from any thread, switches are crossfaded over QUALITYFADEMS
+    void setQualityMode (int mode);
+    int getPinnedQualityMode() const { return mPinnedQualityMode.load(); }
+
+    // the mode the audio thread is currently running and its smoothed processing time as a fraction of the block deadline
+    int getQualityMode() const { return mQualityMode.load(); }
+    float getCpuLoad() const { return mCpuLoad.load(); }
+
+    // when false (offline bounce) there's no deadline to meet, so the governor holds qualityFull unless a mode is pinned
+    void setRealtime (bool isRealtime) { mIsRealtime.store (isRealtime); }
+
+    // which SchroederVerbKernels variant to run, SchroederVerbKernels::automatic picks the widest the CPU supports.
+    // takes effect at the next prepare(), where the CPU features are detected
+    void setKernelVariant (int variant) { mRequestedKernelVariant = variant; }
+    int getKernelVariant() const { return mKernels->variant; }
+
+    // large network mode: numLines comb lines (a multiple of NUMFBCF up to MAXLINES) grown out of the NUMFBCF combs,
+    // split into slices for numThreads worker threads (0 runs them on the calling thread, prepare() never starts more
+    // than there are spare cores, see getNumThreads()). with worker threads the
+    // combs of one block run while the host is busy elsewhere, so the output is one block late, see getLatencySamples().
+    // takes effect at the next prepare(), the default is NUMFBCF lines and no threads
+    void setLargeNetwork (int numLines, int numThreads);
+    int getNumLines() const { return mNumLines; }
+    int getNumThreads() const { return mNumThreads; }
+
+    // the delay the worker threads add to the wet signal, report it to the host after prepare()
+    int getLatencySamples() const { return mNumThreads > 0 ? mMaxBlockSize : 0; }
+
+    double getSampleRate() const { return mSampleRate; }
+    int getMaxBlockSize() const { return mMaxBlockSize; }
+
+private:
+    //==============================================================================
+    // a multichannel ring buffer with one shared write index, reads are relative to the write index
+    class DelayLine
+    {
+    public:
+        void setSize (int numChannels, int numSamples);
+        void clear();
+
+        int getSize() const { return mSize; }
+
+        void write (int channel, const float* source, int numSamples);
+        void writeZeros (int channel, int numSamples);
+        void clearBehind (int channel, int numSamples);
+        void read (int channel, int delay, float* dest, int numSamples) const;
+        void advanceWriteIdx (int numSamples);
+
+    private:
+        std::vector<float> mData;
+        int mNumChannels = 0;
+        int mSize = 0;
+        int mWriteIdx = 0;
+
+        float* getChannel (int channel) { return mData.data() + (size_t) channel * (size_t) mSize; }
+        const float* getChannel (int channel) const { return mData.data() + (size_t) channel * (size_t) mSize; }
+    };
+
+    double mSampleRate;
+    int mMaxBlockSize;
+
+    int mRequestedKernelVariant = SchroederVerbKernels::automatic;
+    const SchroederVerbKernels* mKernels;
+
+    int mRequestedLines = NUMFBCF;
+    int mRequestedThreads = 0;
+    int mNumLines = NUMFBCF;
+    int mNumThreads = 0;                // what prepare() settled on, the workers themselves may be stopped by release()
+    int mNumSlices = 1;                 // the lines are split into one contiguous slice per worker (or one without workers)
+    float mGroupGain = 1.0f;            // every mixing matrix input sums mNumLines / NUMFBCF lines, this keeps the tail level
+
+    // every comb line's output includes its ER input, which adds up coherently instead of like the tails. so each slice
+    // also sums how much ER is in its partial buffers (at the start and end of the block, the line weights ramp
+    // linearly) and the merge corrects it back to the same amount of ER as with NUMFBCF lines
+    float mDirectGains[MAXWORKERTHREADS][NUMFBCF][2];
+
+    DelayLine mFBCFRingBuf;             // mNumLines channels
+    DelayLine mERDelayRingBuf;
+
+    // work buffers, each one channel after the other with mMaxBlockSize samples per channel
+    std::vector<float> mERBuf;          // 2 sets of 2 channels, our workspace for processing the [AP] signals
+    std::vector<float> mDelayBlockBuf;  // mNumSlices channels, the comb line being worked on in each slice
+    std::vector<float> mPartialBuf;     // mNumSlices * NUMFBCF channels, each slice's lines summed per mixing matrix input
+    std::vector<float> mMMBuf;          // NUMFBCF channels, the mixing matrix outputs
+    std::vector<float> mInterleaveBuf;  // 2 channels, planar scratch for processInterleaved()
+    std::vector<float> mERShortBuf;     // 2 channels, the ER output of the shortened chain while crossfading
+    std::vector<float> mERDiffBuf;      // 1 channel, the block written into each ER delay line stage
+    std::vector<float> mLatencyBuf;     // 2 channels of 2 * mMaxBlockSize, the wet output waiting its block of latency
+
+    // using early reflection, feedback comb filter delay times, and feedback gains as suggested in https://ccrma.stanford.edu/~jos/pasp/Schroeder_Reverberators.html
+    double mERDelaysMs[NUMER] = {28.31, 19.82, 13.88, 4.52, 1.48};
+    double mCombFilterDelaysMs[NUMFBCF] = {67.48, 64.04, 82.12, 90.04};
+    double mCombFilterFeedbacks[NUMFBCF] = {77.3, 80.2, 75.3, 73.3};
+
+    int mMMOutLeft;
+    int mMMOutRight;
+
+    // setParameter() only writes these, the audio thread copies them into the values above in applyParameters()
+    std::atomic<double> mPendingERDelaysMs[NUMER];
+    std::atomic<double> mPendingCombDelaysMs[NUMFBCF];
+    std::atomic<double> mPendingCombFeedbacks[NUMFBCF];
+    std::atomic<int> mPendingMatrixOut[2];
+    std::atomic<bool> mParametersPending { false };
+
+    // one per comb line, line l is grown out of comb l % NUMFBCF
+    int mERDelSamps[NUMER];
+    int mFBCFDelSamps[MAXLINES];
+    float mFBCFFdbkCoeffs[MAXLINES];
+
+    // clearing happens on the audio thread: fade out, zero the live part of the delay lines a few chunks per block, fade back in
+    enum ClearState
+    {
+        clearIdle,
+        clearFadingOut,
+        clearZeroing,
+        clearFadingIn
+    };
+
+    std::atomic<bool> mClearRequested { false };
+    ClearState mClearState = clearIdle;
+    float mClearGain = 1.0f;
+    float mClearGainStep = 0.0f;
+    int mFBCFSampsToClear = 0;
+    int mERSampsToClear = 0;
+
+    // quality governor state, only the atomics are touched outside the audio thread
+    std::atomic<int> mPinnedQualityMode { qualityAuto };
+    std::atomic<int> mQualityMode { qualityFull };
+    std::atomic<float> mCpuLoad { 0.0f };
+    std::atomic<bool> mIsRealtime { true };
+    double mSecondsOverBudget = 0.0;
+    double mSecondsUnderBudget = 0.0;
+    int mAutoQualityMode = qualityFull;
+
+    // every mode change ramps these towards their targets by mQualityFadeStep per sample
+    float mQualityFadeStep = 0.0f;
+    float mCombWeights[MAXLINES];
+    float mCombTargets[MAXLINES];
+    bool mCombRunning[MAXLINES];
+    float mERFullWeight = 1.0f;     // 1 = output of the whole ER chain, 0 = output after QUALITYECONOMYERSTAGES
+    float mERFullTarget = 1.0f;
+
+    // worker threads: the audio thread publishes a block of comb work by bumping mJobGeneration, then anyone who
+    // gets to it claims the next slice from mNextSlice and bumps mJobsDone when it's through. at the start of the next
+    // block the audio thread runs whatever nobody claimed itself and waits (bounded) for the rest, no locks
+    std::vector<std::thread> mWorkers;
+    std::atomic<unsigned> mJobGeneration { 0 };
+    std::atomic<int> mNextSlice { 0 };
+    std::atomic<int> mJobsDone { 0 };
+    std::atomic<bool> mStopWorkers { false };
+    int mJobSize = 0;
+    bool mJobInFlight = false;
+
+    // the workers read one ER set while the next block's ER goes into the other. when they're late the next block
+    // still gets its ER and waits in mERSet for its combs (mDeferredSize), meanwhile the wet signal fades out and
+    // the samples that didn't go out are skipped from what the workers deliver next, which keeps the latency at a block
+    int mERSet = 0;
+    int mJobERSet = 0;
+    int mDeferredSize = 0;
+    int mLatencySkip = 0;
+    float mWetGain = 1.0f;
+    float mLastWet[2] = {};
+    int mLatencyReadIdx = 0;
+    int mLatencyWriteIdx = 0;
+
+    float* getERBuf (int set, int channel) { return mERBuf.data() + (size_t) (set * 2 + channel) * (size_t) mMaxBlockSize; }
+    float* getDelayBlockBuf (int channel) { return mDelayBlockBuf.data() + (size_t) channel * (size_t) mMaxBlockSize; }
+    float* getPartialBuf (int slice, int input) { return mPartialBuf.data() + (size_t) (slice * NUMFBCF + input) * (size_t) mMaxBlockSize; }
+    float* getLatencyBuf (int channel) { return mLatencyBuf.data() + (size_t) channel * 2 * (size_t) mMaxBlockSize; }
+    float* getMMBuf (int channel) { return mMMBuf.data() + (size_t) channel * (size_t) mMaxBlockSize; }
+    float* getERShortBuf (int channel) { return mERShortBuf.data() + (size_t) channel * (size_t) mMaxBlockSize; }
+
+    int msToSamps (double ms, const DelayLine& ring) const;
+    void updateLines (int comb);
+    void applyParameters (bool recalculateAll);
+
+    void processBlock (const float* const* inputs, float* const* outputs, int numChannels, int bufSize);
+    void renderBlock (const float* const* inputs, float* const* outputs, int numChannels, int bufSize);
+    void doEarlyReflections (const float* left, const float* right, int bufSize);
+    void doFeedbackCombFilters (int slice, int bufSize);
+    void doMixingMatrix (int bufSize);
+
+    void startWorkers (int numThreads);
+    void stopWorkers();
+    void runWorker (unsigned generation);
+    void runSlices();
+    void startLineJob (int bufSize);
+    bool finishLineJob (std::chrono::steady_clock::time_point deadline);
+    void writeLatencyBuf (int bufSize);
+    void readLatencyBuf (float* const* outputs, int bufSize);
+    void resetLatencyBuf();
+
+    void beginZeroing();
+    bool doZeroingChunks();
+    void applyClearFade (float* const* outputs, int numChannels, int bufSize);
+
+    void updateGovernor (double elapsedSeconds, int bufSize);
+    void applyQualityMode (int mode);
+    void resetQualityState();
+    static float rampTowards (float value, float target, float amount);
+
+    SchroederVerbCore (const SchroederVerbCore&) = delete;
+    SchroederVerbCore& operator= (const SchroederVerbCore&) = delete;
+};
@@ -0,0 +1,170 @@
+/*
+  ==============================================================================
+
+    SchroederVerbKernels.cpp
+
+    The scalar reference kernels and the runtime dispatch.
+
+  ==============================================================================
+*/
+
+#include "SchroederVerbKernels.h"
+
+#include <cstdlib>
+#include <cstring>
+
+#if defined (__x86_64__) || defined (__i386__) || defined (_M_X64) || defined (_M_IX86)
+ #define SCHROEDERVERB_X86 1
+ #if defined (_MSC_VER)
+  #include <intrin.h>
+ #endif
+#else
+ #define SCHROEDERVERB_X86 0
+#endif
+
+//==============================================================================
+namespace
+{
+    struct Vec
+    {
+        using Type = float;
+        static constexpr int width = 1;
+
+        static Type load (const float* source)      { return *source; }
+        static void store (float* dest, Type value) { *dest = value; }
+        static Type broadcast (float value)         { return value; }
+        static Type add (Type a, Type b)            { return a + b; }
+        static Type sub (Type a, Type b)            { return a - b; }
+        static Type mul (Type a, Type b)            { return a * b; }
+        static Type mulAdd (Type a, Type b, Type c) { return a * b + c; }
+        static Type neg (Type a)                    { return -a; }
+        static Type laneIndices()                   { return 0.0f; }
+    };
+}
+
+#define SV_KERNEL_TARGET
+#include "SchroederVerbKernelsImpl.h"
+#undef SV_KERNEL_TARGET
+
+#if SCHROEDERVERB_X86
+// defined in SchroederVerbKernelsSSE2.cpp, SchroederVerbKernelsAVX2.cpp and SchroederVerbKernelsAVX512.cpp
+const SchroederVerbKernels& getSSE2Kernels();
+const SchroederVerbKernels& getAVX2Kernels();
+const SchroederVerbKernels& getAVX512Kernels();
+#endif
+
+//==============================================================================
+namespace
+{
+   #if SCHROEDERVERB_X86 && defined (_MSC_VER)
+    bool osSavesRegisters (unsigned long long mask)
+    {
+        int info[4];
+        __cpuid (info, 1);
+
+        // OSXSAVE, then check the OS actually saves the wider registers on a context switch
+        return (info[2] & (1 << 27)) != 0 && (_xgetbv (0) & mask) == mask;
+    }
+
+    bool hasCpuFeature (int variant)
+    {
+        int info[4];
+
+        switch (variant)
+        {
+            case SchroederVerbKernels::sse2:
+                __cpuid (info, 1);
+                return (info[3] & (1 << 26)) != 0;
+
+            case SchroederVerbKernels::avx2:
+            {
+                __cpuid (info, 1);
+                bool fma = (info[2] & (1 << 12)) != 0;
+                __cpuidex (info, 7, 0);
+                return fma && (info[1] & (1 << 5)) != 0 && osSavesRegisters (0x6);
+            }
+
+            case SchroederVerbKernels::avx512:
+                __cpuidex (info, 7, 0);
+                return (info[1] & (1 << 16)) != 0 && osSavesRegisters (0xe6);
+
+            default:
+                return false;
+        }
+    }
+   #elif SCHROEDERVERB_X86
+    bool hasCpuFeature (int variant)
+    {
+        // these also check the OS has enabled the wider registers
+        switch (variant)
+        {
+            case SchroederVerbKernels::sse2:    return __builtin_cpu_supports ("sse2");
+            case SchroederVerbKernels::avx2:    return __builtin_cpu_supports ("avx2") && __builtin_cpu_supports ("fma");
+            case SchroederVerbKernels::avx512:  return __builtin_cpu_supports ("avx512f");
+            default:                            return false;
+        }
+    }
+   #endif
+
+    const SchroederVerbKernels& getScalarKernels()
+    {
+        static const SchroederVerbKernels kernels = makeKernels (SchroederVerbKernels::scalar, "scalar");
+        return kernels;
+    }
+}
+
+//==============================================================================
+bool SchroederVerbKernels::isSupported (int variant)
+{
+    if (variant == scalar)
+        return true;
+
+   #if SCHROEDERVERB_X86
+    // only ask the CPU once, this runs from prepare() on every stream restart
+    static const bool supported[numVariants] = { true, hasCpuFeature (sse2), hasCpuFeature (avx2), hasCpuFeature (avx512) };
+    return variant > scalar && variant < numVariants && supported[variant];
+   #else
+    return false;
+   #endif
+}
+
+int SchroederVerbKernels::detectBest()
+{
+    for (int variant = numVariants - 1; variant > scalar; --variant)
+        if (isSupported (variant))
+            return variant;
+
+    return scalar;
+}
+
+const char* SchroederVerbKernels::getVariantName (int variant)
+{
+    static const char* names[numVariants] = { "scalar", "sse2", "avx2", "avx512" };
+    return variant >= 0 && variant < numVariants ? names[variant] : "automatic";
+}
+
+const SchroederVerbKernels& SchroederVerbKernels::get (int variant)
+{
+    if (variant == automatic)
+    {
+        variant = detectBest();
+
+        if (const char* forced = std::getenv ("SCHROEDERVERB_KERNELS"))
+            for (int i = 0; i < numVariants; ++i)
+                if (std::strcmp (forced, getVariantName (i)) == 0 && isSupported (i))
+                    variant = i;
+    }
+
+    if (! isSupported (variant))
+        variant = detectBest();
+
+    switch (variant)
+    {
+       #if SCHROEDERVERB_X86
+        case sse2:      return getSSE2Kernels();
+        case avx2:      return getAVX2Kernels();
+        case avx512:    return getAVX512Kernels();
+       #endif
+        default:        return getScalarKernels();
+    }
+}
@@ -0,0 +1,64 @@
+/*
+  ==============================================================================
+
+    SchroederVerbKernels.h
+
+    The inner loops of SchroederVerbCore as a table of function pointers,
+    with one table per instruction set. The widest table the CPU supports is
+    picked at runtime, so one binary runs everywhere without being compiled
+    for the lowest common denominator.
+
+    scalar is the reference, the SIMD tables must match it within rounding
+    (AVX2 and AVX-512 use fused multiply-adds in the comb filters).
+
+  ==============================================================================
+*/
+
+#pragma once
+
+//==============================================================================
+struct SchroederVerbKernels
+{
+    enum Variant
+    {
+        automatic = -1,     // the widest variant the CPU supports
+        scalar,
+        sse2,
+        avx2,               // AVX2 + FMA
+        avx512,             // AVX-512F
+        numVariants
+    };
+
+    int variant;
+    const char* name;
+
+    // first ER stage: sum = (left + right) * gain, diff = (left - right) * gain
+    void (*erInput) (const float* left, const float* right, float* sum, float* diff, int numSamples, float gain);
+
+    // later ER stages: sum = (sum + delayed) * gain, diff = (sum - delayed) * gain using the new sum
+    void (*erStage) (float* sum, const float* delayed, float* diff, int numSamples, float gain);
+
+    // comb filter: block = block * gain + input
+    void (*combFeedback) (float* block, const float* input, int numSamples, float gain);
+
+    // the 4x4 mixing matrix, OutA = s0+s1+s2+s3, OutB = -OutA, OutD = s0+s2-s1-s3, OutC = -OutD
+    void (*mixingMatrix) (const float* const* inputs, float* const* outputs, int numSamples);
+
+    // out = in * gain
+    void (*scale) (const float* input, float* output, int numSamples, float gain);
+
+    // out += in
+    void (*accumulate) (const float* input, float* output, int numSamples);
+
+    // block[i] *= startGain + increment * i
+    void (*applyRamp) (float* block, int numSamples, float startGain, float increment);
+
+    //==============================================================================
+    // returns the table for a variant, unsupported variants fall back to the best supported one.
+    // for automatic the SCHROEDERVERB_KERNELS environment variable (scalar, sse2, avx2, avx512) can force a variant
+    static const SchroederVerbKernels& get (int variant);
+
+    static bool isSupported (int variant);
+    static int detectBest();
+    static const char* getVariantName (int variant);
+};
@@ -0,0 +1,48 @@
+/*
+  ==============================================================================
+
+    SchroederVerbKernelsAVX2.cpp
+
+  ==============================================================================
+*/
+
+#include "SchroederVerbKernels.h"
+
+#if defined (__x86_64__) || defined (__i386__) || defined (_M_X64) || defined (_M_IX86)
+
+#include <immintrin.h>
+
+#if defined (_MSC_VER) && ! defined (__clang__)
+ #define SV_KERNEL_TARGET
+#else
+ #define SV_KERNEL_TARGET __attribute__ ((target ("avx2,fma")))
+#endif
+
+namespace
+{
+    struct Vec
+    {
+        using Type = __m256;
+        static constexpr int width = 8;
+
+        SV_KERNEL_TARGET static Type load (const float* source)      { return _mm256_loadu_ps (source); }
+        SV_KERNEL_TARGET static void store (float* dest, Type value) { _mm256_storeu_ps (dest, value); }
+        SV_KERNEL_TARGET static Type broadcast (float value)         { return _mm256_set1_ps (value); }
+        SV_KERNEL_TARGET static Type add (Type a, Type b)            { return _mm256_add_ps (a, b); }
+        SV_KERNEL_TARGET static Type sub (Type a, Type b)            { return _mm256_sub_ps (a, b); }
+        SV_KERNEL_TARGET static Type mul (Type a, Type b)            { return _mm256_mul_ps (a, b); }
+        SV_KERNEL_TARGET static Type mulAdd (Type a, Type b, Type c) { return _mm256_fmadd_ps (a, b, c); }
+        SV_KERNEL_TARGET static Type neg (Type a)                    { return _mm256_xor_ps (a, _mm256_set1_ps (-0.0f)); }
+        SV_KERNEL_TARGET static Type laneIndices()                   { return _mm256_setr_ps (0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f); }
+    };
+}
+
+#include "SchroederVerbKernelsImpl.h"
+
+const SchroederVerbKernels& getAVX2Kernels()
+{
+    static const SchroederVerbKernels kernels = makeKernels (SchroederVerbKernels::avx2, "avx2");
+    return kernels;
+}
+
+#endif
@@ -0,0 +1,58 @@
+/*
+  ==============================================================================
+
+    SchroederVerbKernelsAVX512.cpp
+
+  ==============================================================================
+*/
+
+#include "SchroederVerbKernels.h"
+
+#if defined (__x86_64__) || defined (__i386__) || defined (_M_X64) || defined (_M_IX86)
+
+#include <immintrin.h>
+
+#if defined (_MSC_VER) && ! defined (__clang__)
+ #define SV_KERNEL_TARGET
+#else
+ #define SV_KERNEL_TARGET __attribute__ ((target ("avx512f")))
+#endif
+
+namespace
+{
+    struct Vec
+    {
+        using Type = __m512;
+        static constexpr int width = 16;
+
+        SV_KERNEL_TARGET static Type load (const float* source)      { return _mm512_loadu_ps (source); }
+        SV_KERNEL_TARGET static void store (float* dest, Type value) { _mm512_storeu_ps (dest, value); }
+        SV_KERNEL_TARGET static Type broadcast (float value)         { return _mm512_set1_ps (value); }
+        SV_KERNEL_TARGET static Type add (Type a, Type b)            { return _mm512_add_ps (a, b); }
+        SV_KERNEL_TARGET static Type sub (Type a, Type b)            { return _mm512_sub_ps (a, b); }
+        SV_KERNEL_TARGET static Type mul (Type a, Type b)            { return _mm512_mul_ps (a, b); }
+        SV_KERNEL_TARGET static Type mulAdd (Type a, Type b, Type c) { return _mm512_fmadd_ps (a, b, c); }
+
+        // _mm512_xor_ps needs AVX-512DQ, so flip the sign bit through the integer unit
+        SV_KERNEL_TARGET static Type neg (Type a)
+        {
+            return _mm512_castsi512_ps (_mm512_xor_si512 (_mm512_castps_si512 (a), _mm512_set1_epi32 ((int) 0x80000000)));
+        }
+
+        SV_KERNEL_TARGET static Type laneIndices()
+        {
+            return _mm512_setr_ps (0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f,
+                                   8.0f, 9.0f, 10.0f, 11.0f, 12.0f, 13.0f, 14.0f, 15.0f);
+        }
+    };
+}
+
+#include "SchroederVerbKernelsImpl.h"
+
+const SchroederVerbKernels& getAVX512Kernels()
+{
+    static const SchroederVerbKernels kernels = makeKernels (SchroederVerbKernels::avx512, "avx512");
+    return kernels;
+}
+
+#endif
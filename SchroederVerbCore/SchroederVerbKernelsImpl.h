@@ -0,0 +1,158 @@
+/*
+  ==============================================================================
+
+    SchroederVerbKernelsImpl.h
+
+    The kernel bodies, written once against a small vector type. Each
+    SchroederVerbKernels*.cpp defines Vec and SV_KERNEL_TARGET and then
+    includes this file, so there's deliberately no include guard.
+
+    Vec needs: width, Type, load, store, broadcast, add, sub, mul, mulAdd,
+    neg and laneIndices (0, 1, 2, ... as a Type).
+
+  ==============================================================================
+*/
+
+namespace
+{
+    SV_KERNEL_TARGET void erInput (const float* left, const float* right, float* sum, float* diff, int numSamples, float gain)
+    {
+        const auto g = Vec::broadcast (gain);
+        int i = 0;
+
+        for (; i + Vec::width <= numSamples; i += Vec::width)
+        {
+            auto l = Vec::load (left + i);
+            auto r = Vec::load (right + i);
+            Vec::store (sum + i, Vec::mul (Vec::add (l, r), g));
+            Vec::store (diff + i, Vec::mul (Vec::sub (l, r), g));
+        }
+
+        for (; i < numSamples; ++i)
+        {
+            sum[i] = (left[i] + right[i]) * gain;
+            diff[i] = (left[i] - right[i]) * gain;
+        }
+    }
+
+    SV_KERNEL_TARGET void erStage (float* sum, const float* delayed, float* diff, int numSamples, float gain)
+    {
+        const auto g = Vec::broadcast (gain);
+        int i = 0;
+
+        for (; i + Vec::width <= numSamples; i += Vec::width)
+        {
+            auto d = Vec::load (delayed + i);
+            auto s = Vec::mul (Vec::add (Vec::load (sum + i), d), g);
+            Vec::store (sum + i, s);
+            Vec::store (diff + i, Vec::mul (Vec::sub (s, d), g));
+        }
+
+        for (; i < numSamples; ++i)
+        {
+            sum[i] = (sum[i] + delayed[i]) * gain;
+            diff[i] = (sum[i] - delayed[i]) * gain;
+        }
+    }
+
+    SV_KERNEL_TARGET void combFeedback (float* block, const float* input, int numSamples, float gain)
+    {
+        const auto g = Vec::broadcast (gain);
+        int i = 0;
+
+        for (; i + Vec::width <= numSamples; i += Vec::width)
+            Vec::store (block + i, Vec::mulAdd (Vec::load (block + i), g, Vec::load (input + i)));
+
+        for (; i < numSamples; ++i)
+            block[i] = block[i] * gain + input[i];
+    }
+
+    SV_KERNEL_TARGET void mixingMatrix (const float* const* inputs, float* const* outputs, int numSamples)
+    {
+        const float* s0 = inputs[0];
+        const float* s1 = inputs[1];
+        const float* s2 = inputs[2];
+        const float* s3 = inputs[3];
+        int i = 0;
+
+        for (; i + Vec::width <= numSamples; i += Vec::width)
+        {
+            auto mix1 = Vec::add (Vec::load (s0 + i), Vec::load (s2 + i));
+            auto mix2 = Vec::add (Vec::load (s1 + i), Vec::load (s3 + i));
+            auto outA = Vec::add (mix1, mix2);
+            auto outD = Vec::sub (mix1, mix2);
+
+            Vec::store (outputs[0] + i, outA);
+            Vec::store (outputs[1] + i, Vec::neg (outA));
+            Vec::store (outputs[2] + i, Vec::neg (outD));
+            Vec::store (outputs[3] + i, outD);
+        }
+
+        for (; i < numSamples; ++i)
+        {
+            float mix1 = s0[i] + s2[i];
+            float mix2 = s1[i] + s3[i];
+
+            outputs[0][i] = mix1 + mix2;
+            outputs[1][i] = -(mix1 + mix2);
+            outputs[2][i] = -(mix1 - mix2);
+            outputs[3][i] = mix1 - mix2;
+        }
+    }
+
+    SV_KERNEL_TARGET void scale (const float* input, float* output, int numSamples, float gain)
+    {
+        const auto g = Vec::broadcast (gain);
+        int i = 0;
+
+        for (; i + Vec::width <= numSamples; i += Vec::width)
+            Vec::store (output + i, Vec::mul (Vec::load (input + i), g));
+
+        for (; i < numSamples; ++i)
+            output[i] = input[i] * gain;
+    }
+
+    SV_KERNEL_TARGET void accumulate (const float* input, float* output, int numSamples)
+    {
+        int i = 0;
+
+        for (; i + Vec::width <= numSamples; i += Vec::width)
+            Vec::store (output + i, Vec::add (Vec::load (output + i), Vec::load (input + i)));
+
+        for (; i < numSamples; ++i)
+            output[i] += input[i];
+    }
+
+    SV_KERNEL_TARGET void applyRamp (float* block, int numSamples, float startGain, float increment)
+    {
+        // same arithmetic as the scalar loop: startGain + increment * (float) i, with i exact in a float
+        const auto start = Vec::broadcast (startGain);
+        const auto inc = Vec::broadcast (increment);
+        int i = 0;
+
+        for (; i + Vec::width <= numSamples; i += Vec::width)
+        {
+            auto index = Vec::add (Vec::broadcast ((float) i), Vec::laneIndices());
+            auto gain = Vec::add (start, Vec::mul (inc, index));
+            Vec::store (block + i, Vec::mul (Vec::load (block + i), gain));
+        }
+
+        for (; i < numSamples; ++i)
+            block[i] *= startGain + increment * (float) i;
+    }
+
+    SchroederVerbKernels makeKernels (int variant, const char* name)
+    {
+        SchroederVerbKernels kernels;
+        kernels.variant = variant;
+        kernels.name = name;
+        kernels.erInput = erInput;
+        kernels.erStage = erStage;
+        kernels.combFeedback = combFeedback;
+        kernels.mixingMatrix = mixingMatrix;
+        kernels.scale = scale;
+        kernels.accumulate = accumulate;
+        kernels.applyRamp = applyRamp;
+        return kernels;
+    }
+}
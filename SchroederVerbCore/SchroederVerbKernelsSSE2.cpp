@@ -0,0 +1,48 @@
+/*
+  ==============================================================================
+
+    SchroederVerbKernelsSSE2.cpp
+
+  ==============================================================================
+*/
+
+#include "SchroederVerbKernels.h"
+
+#if defined (__x86_64__) || defined (__i386__) || defined (_M_X64) || defined (_M_IX86)
+
+#include <emmintrin.h>
+
+#if defined (_MSC_VER) && ! defined (__clang__)
+ #define SV_KERNEL_TARGET
+#else
+ #define SV_KERNEL_TARGET __attribute__ ((target ("sse2")))
+#endif
+
+namespace
+{
+    struct Vec
+    {
+        using Type = __m128;
+        static constexpr int width = 4;
+
+        SV_KERNEL_TARGET static Type load (const float* source)      { return _mm_loadu_ps (source); }
+        SV_KERNEL_TARGET static void store (float* dest, Type value) { _mm_storeu_ps (dest, value); }
+        SV_KERNEL_TARGET static Type broadcast (float value)         { return _mm_set1_ps (value); }
+        SV_KERNEL_TARGET static Type add (Type a, Type b)            { return _mm_add_ps (a, b); }
+        SV_KERNEL_TARGET static Type sub (Type a, Type b)            { return _mm_sub_ps (a, b); }
+        SV_KERNEL_TARGET static Type mul (Type a, Type b)            { return _mm_mul_ps (a, b); }
+        SV_KERNEL_TARGET static Type mulAdd (Type a, Type b, Type c) { return _mm_add_ps (_mm_mul_ps (a, b), c); }
+        SV_KERNEL_TARGET static Type neg (Type a)                    { return _mm_xor_ps (a, _mm_set1_ps (-0.0f)); }
+        SV_KERNEL_TARGET static Type laneIndices()                   { return _mm_setr_ps (0.0f, 1.0f, 2.0f, 3.0f); }
+    };
+}
+
+#include "SchroederVerbKernelsImpl.h"
+
+const SchroederVerbKernels& getSSE2Kernels()
+{
+    static const SchroederVerbKernels kernels = makeKernels (SchroederVerbKernels::sse2, "sse2");
+    return kernels;
+}
+
+#endif
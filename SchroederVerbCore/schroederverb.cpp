@@ -0,0 +1,135 @@
+/*
+  ==============================================================================
+
+    schroederverb.cpp
+
+  ==============================================================================
+*/
+
+#include "schroederverb.h"
+#include "SchroederVerbCore.h"
+
+#include <new>
+
+static_assert (SCHROEDERVERB_QUALITY_AUTO == (int) SchroederVerbCore::qualityAuto
+                && SCHROEDERVERB_QUALITY_FULL == (int) SchroederVerbCore::qualityFull
+                && SCHROEDERVERB_QUALITY_REDUCED == (int) SchroederVerbCore::qualityReduced
+                && SCHROEDERVERB_QUALITY_ECONOMY == (int) SchroederVerbCore::qualityEconomy,
+               "the C quality modes have to match SchroederVerbCore::QualityMode");
+
+static_assert (SCHROEDERVERB_KERNELS_AUTOMATIC == (int) SchroederVerbKernels::automatic
+                && SCHROEDERVERB_KERNELS_SCALAR == (int) SchroederVerbKernels::scalar
+                && SCHROEDERVERB_KERNELS_SSE2 == (int) SchroederVerbKernels::sse2
+                && SCHROEDERVERB_KERNELS_AVX2 == (int) SchroederVerbKernels::avx2
+                && SCHROEDERVERB_KERNELS_AVX512 == (int) SchroederVerbKernels::avx512,
+               "the C kernel variants have to match SchroederVerbKernels::Variant");
+
+struct SchroederVerb
+{
+    SchroederVerbCore core;
+};
+
+SchroederVerb* schroederverb_create (void)
+{
+    return new (std::nothrow) SchroederVerb();
+}
+
+void schroederverb_destroy (SchroederVerb* verb)
+{
+    delete verb;
+}
+
+void schroederverb_prepare (SchroederVerb* verb, double sampleRate, int maxBlockSize)
+{
+    verb->core.prepare (sampleRate, maxBlockSize);
+}
+
+void schroederverb_process_planar (SchroederVerb* verb, const float* const* inputs, float* const* outputs, int numChannels, int numSamples)
+{
+    verb->core.processPlanar (inputs, outputs, numChannels, numSamples);
+}
+
+void schroederverb_process_interleaved (SchroederVerb* verb, const float* input, float* output, int numChannels, int numSamples)
+{
+    verb->core.processInterleaved (input, output, numChannels, numSamples);
+}
+
+void schroederverb_set_parameter (SchroederVerb* verb, int parameter, int index, double value)
+{
+    verb->core.setParameter ((SchroederVerbCore::Parameter) parameter, index, value);
+}
+
+double schroederverb_get_parameter (const SchroederVerb* verb, int parameter, int index)
+{
+    return verb->core.getParameter ((SchroederVerbCore::Parameter) parameter, index);
+}
+
+void schroederverb_reset (SchroederVerb* verb)
+{
+    verb->core.reset();
+}
+
+void schroederverb_request_clear (SchroederVerb* verb)
+{
+    verb->core.requestClear();
+}
+
+void schroederverb_set_quality_mode (SchroederVerb* verb, int mode)
+{
+    verb->core.setQualityMode (mode);
+}
+
+int schroederverb_get_pinned_quality_mode (const SchroederVerb* verb)
+{
+    return verb->core.getPinnedQualityMode();
+}
+
+int schroederverb_get_quality_mode (const SchroederVerb* verb)
+{
+    return verb->core.getQualityMode();
+}
+
+float schroederverb_get_cpu_load (const SchroederVerb* verb)
+{
+    return verb->core.getCpuLoad();
+}
+
+void schroederverb_set_realtime (SchroederVerb* verb, int isRealtime)
+{
+    verb->core.setRealtime (isRealtime != 0);
+}
+
+void schroederverb_set_kernel_variant (SchroederVerb* verb, int variant)
+{
+    verb->core.setKernelVariant (variant);
+}
+
+int schroederverb_get_kernel_variant (const SchroederVerb* verb)
+{
+    return verb->core.getKernelVariant();
+}
+
+void schroederverb_set_large_network (SchroederVerb* verb, int numLines, int numThreads)
+{
+    verb->core.setLargeNetwork (numLines, numThreads);
+}
+
+int schroederverb_get_latency_samples (const SchroederVerb* verb)
+{
+    return verb->core.getLatencySamples();
+}
+
+int schroederverb_get_num_lines (const SchroederVerb* verb)
+{
+    return verb->core.getNumLines();
+}
+
+int schroederverb_get_num_threads (const SchroederVerb* verb)
+{
+    return verb->core.getNumThreads();
+}
+
+void schroederverb_release (SchroederVerb* verb)
+{
+    verb->core.release();
+}
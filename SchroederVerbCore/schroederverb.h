@@ -0,0 +1,91 @@
+/*
+  ==============================================================================
+
+    schroederverb.h
+
+    Plain C interface to SchroederVerbCore, for hosts that can't use the
+    C++ class directly. All functions map one to one onto the class.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct SchroederVerb SchroederVerb;
+
+enum
+{
+    SCHROEDERVERB_ER_DELAY_MS = 0,      /* index 0..4, milliseconds */
+    SCHROEDERVERB_COMB_DELAY_MS = 1,    /* index 0..3, milliseconds */
+    SCHROEDERVERB_COMB_FEEDBACK = 2,    /* index 0..3, percent */
+    SCHROEDERVERB_MATRIX_OUT = 3        /* index 0 = left, 1 = right, value 0..3 (OutA..OutD) */
+};
+
+/* same values as SchroederVerbCore::QualityMode */
+enum
+{
+    SCHROEDERVERB_QUALITY_AUTO = -1,    /* only for schroederverb_set_quality_mode, let the governor decide */
+    SCHROEDERVERB_QUALITY_FULL = 0,     /* all comb lines and ER stages */
+    SCHROEDERVERB_QUALITY_REDUCED = 1,  /* half the comb lines */
+    SCHROEDERVERB_QUALITY_ECONOMY = 2   /* half the comb lines and fewer ER stages */
+};
+
+/* same values as SchroederVerbKernels::Variant */
+enum
+{
+    SCHROEDERVERB_KERNELS_AUTOMATIC = -1,   /* the widest the CPU supports */
+    SCHROEDERVERB_KERNELS_SCALAR = 0,
+    SCHROEDERVERB_KERNELS_SSE2 = 1,
+    SCHROEDERVERB_KERNELS_AVX2 = 2,         /* AVX2 + FMA */
+    SCHROEDERVERB_KERNELS_AVX512 = 3        /* AVX-512F */
+};
+
+SchroederVerb* schroederverb_create (void);
+void schroederverb_destroy (SchroederVerb* verb);
+
+/* allocates everything, nothing below allocates afterwards */
+void schroederverb_prepare (SchroederVerb* verb, double sampleRate, int maxBlockSize);
+
+/* numChannels or numSamples of 0 (or less) does nothing, the buffers may be NULL then */
+void schroederverb_process_planar (SchroederVerb* verb, const float* const* inputs, float* const* outputs, int numChannels, int numSamples);
+void schroederverb_process_interleaved (SchroederVerb* verb, const float* input, float* output, int numChannels, int numSamples);
+
+/* safe from any thread, applies at the start of the next processed block */
+void schroederverb_set_parameter (SchroederVerb* verb, int parameter, int index, double value);
+double schroederverb_get_parameter (const SchroederVerb* verb, int parameter, int index);
+
+/* zeroes the delay lines immediately, not for the audio thread */
+void schroederverb_reset (SchroederVerb* verb);
+/* real-time safe clear, faded and spread over the next few blocks */
+void schroederverb_request_clear (SchroederVerb* verb);
+
+/* pins a quality mode, or SCHROEDERVERB_QUALITY_AUTO hands it back to the governor. safe from any thread */
+void schroederverb_set_quality_mode (SchroederVerb* verb, int mode);
+int schroederverb_get_pinned_quality_mode (const SchroederVerb* verb);
+/* the mode the audio thread is running and its smoothed load as a fraction of the block deadline */
+int schroederverb_get_quality_mode (const SchroederVerb* verb);
+float schroederverb_get_cpu_load (const SchroederVerb* verb);
+/* 0 for offline rendering, the governor then holds SCHROEDERVERB_QUALITY_FULL unless a mode is pinned */
+void schroederverb_set_realtime (SchroederVerb* verb, int isRealtime);
+
+/* picks the SIMD kernels, applies at the next prepare. get returns the variant prepare chose */
+void schroederverb_set_kernel_variant (SchroederVerb* verb, int variant);
+int schroederverb_get_kernel_variant (const SchroederVerb* verb);
+
+/* numLines comb lines (4..64) split across numThreads worker threads (0 = none), applies at the next prepare */
+void schroederverb_set_large_network (SchroederVerb* verb, int numLines, int numThreads);
+/* the block of latency the worker threads add, 0 without them */
+int schroederverb_get_latency_samples (const SchroederVerb* verb);
+/* what the last prepare settled on, it never starts more threads than there are spare cores */
+int schroederverb_get_num_lines (const SchroederVerb* verb);
+int schroederverb_get_num_threads (const SchroederVerb* verb);
+/* stops the worker threads until the next prepare, for when the host stops processing */
+void schroederverb_release (SchroederVerb* verb);
+
+#ifdef __cplusplus
+}
+#endif
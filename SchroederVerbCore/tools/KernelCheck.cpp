@@ -0,0 +1,175 @@
+/*
+  ==============================================================================
+
+    KernelCheck.cpp
+
+    Checks every SchroederVerbKernels variant this CPU supports against the
+    scalar reference: first each kernel on its own, then a whole render
+    through SchroederVerbCore with quality switches and a clear, so the
+    feedback paths get to accumulate any difference.
+
+    usage: schroederverb_kernelcheck
+
+  ==============================================================================
+*/
+
+#include "SchroederVerbCore.h"
+#include "SchroederVerbKernels.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+namespace
+{
+    // FMA rounds once instead of twice, so the kernels may differ by about an ulp
+    const float kernelTolerance = 1.0e-6f;
+    // after seconds of recirculating through the combs, relative to the peak output
+    const float renderTolerance = 1.0e-4f;
+
+    float maxDifference (const std::vector<float>& a, const std::vector<float>& b)
+    {
+        float difference = 0.0f;
+
+        for (size_t i = 0; i < a.size(); ++i)
+            difference = std::max (difference, std::abs (a[i] - b[i]));
+
+        return difference;
+    }
+
+    // runs the same inputs through the kernels of one variant, returns the largest difference to the reference outputs
+    float checkKernels (const SchroederVerbKernels& kernels, const SchroederVerbKernels& reference)
+    {
+        // an odd length so the scalar tails after the vector loops are covered too
+        const int numSamples = 1021;
+        std::mt19937 rng (42);
+        std::uniform_real_distribution<float> signal (-1.0f, 1.0f);
+
+        auto random = [&] { std::vector<float> v ((size_t) numSamples); for (auto& x : v) x = signal (rng); return v; };
+
+        auto left = random(), right = random(), block = random(), input = random();
+        std::vector<float> s[NUMFBCF] = { random(), random(), random(), random() };
+        const float* matrixIn[NUMFBCF] = { s[0].data(), s[1].data(), s[2].data(), s[3].data() };
+
+        float worst = 0.0f;
+
+        auto compare = [&] (auto&& run)
+        {
+            std::vector<float> a[NUMFBCF], b[NUMFBCF];
+
+            for (int i = 0; i < NUMFBCF; ++i)
+            {
+                a[i] = block;
+                b[i] = block;
+            }
+
+            run (kernels, a);
+            run (reference, b);
+
+            for (int i = 0; i < NUMFBCF; ++i)
+                worst = std::max (worst, maxDifference (a[i], b[i]));
+        };
+
+        compare ([&] (const SchroederVerbKernels& k, std::vector<float>* out)
+                 { k.erInput (left.data(), right.data(), out[0].data(), out[1].data(), numSamples, (float) APGAIN); });
+
+        compare ([&] (const SchroederVerbKernels& k, std::vector<float>* out)
+                 { k.erStage (out[0].data(), input.data(), out[1].data(), numSamples, (float) APGAIN); });
+
+        compare ([&] (const SchroederVerbKernels& k, std::vector<float>* out)
+                 { k.combFeedback (out[0].data(), input.data(), numSamples, 0.773f); });
+
+        compare ([&] (const SchroederVerbKernels& k, std::vector<float>* out)
+                 {
+                     float* matrixOut[NUMFBCF] = { out[0].data(), out[1].data(), out[2].data(), out[3].data() };
+                     k.mixingMatrix (matrixIn, matrixOut, numSamples);
+                 });
+
+        compare ([&] (const SchroederVerbKernels& k, std::vector<float>* out)
+                 { k.scale (input.data(), out[0].data(), numSamples, (float) OUTPUTGAIN); });
+
+        compare ([&] (const SchroederVerbKernels& k, std::vector<float>* out)
+                 { k.accumulate (input.data(), out[0].data(), numSamples); });
+
+        compare ([&] (const SchroederVerbKernels& k, std::vector<float>* out)
+                 { k.applyRamp (out[0].data(), numSamples, 0.25f, 1.0f / (float) numSamples); });
+
+        return worst;
+    }
+
+    // a noise burst and its tail through a whole core, with the block sizes and events every variant sees alike
+    std::vector<float> render (int variant)
+    {
+        const double sampleRate = 48000.0;
+        const int maxBlockSize = 512;
+        const int numSamples = (int) (4.0 * sampleRate);
+
+        SchroederVerbCore core;
+        core.setKernelVariant (variant);
+        core.setQualityMode (SchroederVerbCore::qualityFull);
+        core.prepare (sampleRate, maxBlockSize);
+
+        std::vector<float> left ((size_t) numSamples, 0.0f), right ((size_t) numSamples, 0.0f);
+        std::mt19937 rng (7);
+        std::uniform_real_distribution<float> signal (-0.5f, 0.5f);
+        std::uniform_int_distribution<int> blockSizes (1, maxBlockSize);
+
+        for (int i = 0; i < numSamples / 4; ++i)
+        {
+            left[(size_t) i] = signal (rng);
+            right[(size_t) i] = signal (rng);
+        }
+
+        for (int pos = 0, block = 0; pos < numSamples; ++block)
+        {
+            // walk through every quality mode and a clear so the ramp kernels run too
+            if (block == 300)   core.setQualityMode (SchroederVerbCore::qualityEconomy);
+            if (block == 600)   core.setQualityMode (SchroederVerbCore::qualityFull);
+            if (block == 900)   core.requestClear();
+
+            int bufSize = std::min (blockSizes (rng), numSamples - pos);
+            float* channels[2] = { left.data() + pos, right.data() + pos };
+            core.processPlanar (channels, channels, 2, bufSize);
+            pos += bufSize;
+        }
+
+        left.insert (left.end(), right.begin(), right.end());
+        return left;
+    }
+}
+
+int main()
+{
+    const auto& reference = SchroederVerbKernels::get (SchroederVerbKernels::scalar);
+    const auto referenceRender = render (SchroederVerbKernels::scalar);
+
+    float peak = 0.0f;
+    for (float sample : referenceRender)
+        peak = std::max (peak, std::abs (sample));
+
+    std::printf ("automatic picks %s\n", SchroederVerbKernels::get (SchroederVerbKernels::automatic).name);
+
+    bool passed = true;
+
+    for (int variant = SchroederVerbKernels::scalar + 1; variant < SchroederVerbKernels::numVariants; ++variant)
+    {
+        if (! SchroederVerbKernels::isSupported (variant))
+        {
+            std::printf ("%-8s not supported on this CPU, skipped\n", SchroederVerbKernels::getVariantName (variant));
+            continue;
+        }
+
+        float kernelDifference = checkKernels (SchroederVerbKernels::get (variant), reference);
+        float renderDifference = maxDifference (render (variant), referenceRender) / peak;
+        bool ok = kernelDifference <= kernelTolerance && renderDifference <= renderTolerance;
+
+        std::printf ("%-8s kernels max diff %g, render max diff %g of peak: %s\n",
+                     SchroederVerbKernels::getVariantName (variant), kernelDifference, renderDifference, ok ? "ok" : "FAILED");
+
+        passed = passed && ok;
+    }
+
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,101 @@
+/*
+  ==============================================================================
+
+    RealtimeFuzz.cpp
+
+    Drives SchroederVerbCore the way a host would, with random block sizes,
+    channel counts, parameter changes, quality modes and clears, while
+    RealtimeCheck watches the processing thread. Any allocation, lock or I/O
+    on that thread is printed with a stack trace and makes the run fail.
+    Give numLines and numThreads to fuzz the large network mode, the worker
+    threads aren't watched but the barrier on the audio thread is.
+
+    usage: schroederverb_rtfuzz [numBlocks] [seed] [numLines numThreads]
+
+  ==============================================================================
+*/
+
+#include "SchroederVerbCore.h"
+#include "RealtimeCheck.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+int main (int argc, char* argv[])
+{
+    const int numBlocks = argc > 1 ? std::atoi (argv[1]) : 20000;
+    const unsigned seed = argc > 2 ? (unsigned) std::strtoul (argv[2], nullptr, 10) : 1234u;
+    const int numLines = argc > 4 ? std::atoi (argv[3]) : NUMFBCF;
+    const int numThreads = argc > 4 ? std::atoi (argv[4]) : 0;
+
+    if (! RealtimeCheck::isSupported())
+        std::printf ("warning: real-time hooks aren't available on this platform, nothing will be caught\n");
+
+    const int maxBlockSize = 1024;
+    const int maxChannels = 4;
+
+    // everything the host would allocate up front, outside the checked scope.
+    // blocks go up to twice maxBlockSize so the core's own chunking gets exercised too
+    std::vector<float> planar ((size_t) maxChannels * 2 * maxBlockSize);
+    std::vector<float> interleaved ((size_t) maxChannels * 2 * maxBlockSize);
+    float* channels[maxChannels];
+
+    for (int channel = 0; channel < maxChannels; ++channel)
+        channels[channel] = planar.data() + (size_t) channel * 2 * maxBlockSize;
+
+    SchroederVerbCore core;
+    core.setLargeNetwork (numLines, numThreads);
+    core.prepare (48000.0, maxBlockSize);
+
+    std::mt19937 rng (seed);
+    std::uniform_real_distribution<float> signal (-1.0f, 1.0f);
+    std::uniform_real_distribution<double> unit (0.0, 1.0);
+    std::uniform_int_distribution<int> blockSizes (1, 2 * maxBlockSize);
+    std::uniform_int_distribution<int> channelCounts (1, maxChannels);
+
+    RealtimeCheck::resetViolations();
+
+    for (int block = 0; block < numBlocks; ++block)
+    {
+        const int numSamples = blockSizes (rng);
+        const int numChannels = channelCounts (rng);
+        const bool useInterleaved = unit (rng) < 0.3;
+        const double event = unit (rng);
+
+        // the host fills its buffers before calling into the plugin
+        for (int i = 0; i < numChannels * numSamples; ++i)
+        {
+            planar[(size_t) (i / numSamples) * 2 * maxBlockSize + (size_t) (i % numSamples)] = signal (rng);
+            interleaved[(size_t) i] = signal (rng);
+        }
+
+        RealtimeCheck::ScopedAudioThread audioThread;
+
+        // parameter changes and clears land between blocks, including out of range values
+        if (event < 0.05)
+            core.setParameter (SchroederVerbCore::erDelayMs, (int) (unit (rng) * NUMER), unit (rng) * 120.0 - 10.0);
+        else if (event < 0.10)
+            core.setParameter (SchroederVerbCore::combDelayMs, (int) (unit (rng) * NUMFBCF), unit (rng) * 200.0 - 10.0);
+        else if (event < 0.15)
+            core.setParameter (SchroederVerbCore::combFeedback, (int) (unit (rng) * NUMFBCF), unit (rng) * 99.0);
+        else if (event < 0.18)
+            core.setParameter (SchroederVerbCore::matrixOut, (int) (unit (rng) * 2), unit (rng) * 5.0 - 1.0);
+        else if (event < 0.20)
+            core.requestClear();
+        else if (event < 0.22)
+            core.setQualityMode ((int) (unit (rng) * (SchroederVerbCore::numQualityModes + 1)) - 1);
+
+        if (useInterleaved)
+            core.processInterleaved (interleaved.data(), interleaved.data(), numChannels, numSamples);
+        else
+            core.processPlanar (channels, channels, numChannels, numSamples);
+    }
+
+    const int numViolations = RealtimeCheck::getNumViolations();
+    std::printf ("%d blocks, seed %u, %d lines on %d worker thread(s): %d real-time violation(s)\n",
+                 numBlocks, seed, core.getNumLines(), core.getNumThreads(), numViolations);
+
+    return numViolations == 0 ? 0 : 1;
+}
@@ -0,0 +1,166 @@
+/*
+  ==============================================================================
+
+    ScalingBench.cpp
+
+    Times the large network mode at small block sizes with the comb lines on
+    the calling thread and on 1, 2, 4 and 8 worker threads, and prints the
+    speedup over the calling thread and the scaling efficiency (speedup per
+    worker). The host's own work between blocks isn't simulated, so this is
+    the throughput with the audio thread waiting at the barrier every block.
+    The core never starts more workers than there are spare cores, counts
+    above that are skipped. Every run renders the same noise, and the peak
+    column is the last block's loudest output sample, to show the network
+    stayed stable. With --markdown the table comes out ready to paste into
+    the README.
+
+    usage: schroederverb_scalingbench [seconds of audio per run] [--markdown]
+
+  ==============================================================================
+*/
+
+#include "SchroederVerbCore.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    const int warmupBlocks = 200;
+
+    // the same stereo noise for every run, long enough for the warm-up and the timed part
+    struct Noise
+    {
+        Noise (int numSamples)
+            : left ((size_t) numSamples), right ((size_t) numSamples)
+        {
+            std::mt19937 rng (3);
+            std::uniform_real_distribution<float> signal (-0.5f, 0.5f);
+
+            for (int sample = 0; sample < numSamples; ++sample)
+            {
+                left[(size_t) sample] = signal (rng);
+                right[(size_t) sample] = signal (rng);
+            }
+        }
+
+        std::vector<float> left, right;
+    };
+
+    // wall clock seconds to render numSamples of noise through a core set up with numLines and numThreads.
+    // the output goes to its own buffers, feeding it back in as the next block's input would run away.
+    // peak is the loudest output sample, a sanity check that the network stayed stable
+    double timeRender (const Noise& noise, int numLines, int numThreads, int blockSize, int numSamples, float& peak)
+    {
+        const double sampleRate = 48000.0;
+
+        SchroederVerbCore core;
+        core.setLargeNetwork (numLines, numThreads);
+        core.setQualityMode (SchroederVerbCore::qualityFull);
+        core.prepare (sampleRate, blockSize);
+
+        std::vector<float> outLeft ((size_t) blockSize), outRight ((size_t) blockSize);
+        float* outputs[2] = { outLeft.data(), outRight.data() };
+        int pos = 0;
+
+        auto processNext = [&]
+        {
+            const float* inputs[2] = { noise.left.data() + pos, noise.right.data() + pos };
+            core.processPlanar (inputs, outputs, 2, blockSize);
+            pos += blockSize;
+        };
+
+        // warm up the caches and let the workers get going before the clock starts
+        for (int block = 0; block < warmupBlocks; ++block)
+            processNext();
+
+        auto start = std::chrono::steady_clock::now();
+
+        for (int block = 0; block < numSamples / blockSize; ++block)
+            processNext();
+
+        const double elapsed = std::chrono::duration<double> (std::chrono::steady_clock::now() - start).count();
+
+        peak = 0.0f;
+
+        for (int sample = 0; sample < blockSize; ++sample)
+            peak = std::max ({ peak, std::abs (outLeft[(size_t) sample]), std::abs (outRight[(size_t) sample]) });
+
+        return elapsed;
+    }
+
+    void printRow (bool markdown, const std::string& lines, const std::string& block, const std::string& workers,
+                   const std::string& realtime, const std::string& load, const std::string& speedup,
+                   const std::string& efficiency, const std::string& peak)
+    {
+        const char* format = markdown ? "| %s | %s | %s | %s | %s | %s | %s | %s |\n"
+                                      : "%5s %6s %8s %10s %8s %8s %10s %8s\n";
+
+        std::printf (format, lines.c_str(), block.c_str(), workers.c_str(), realtime.c_str(), load.c_str(),
+                     speedup.c_str(), efficiency.c_str(), peak.c_str());
+    }
+
+    std::string formatValue (const char* format, double value)
+    {
+        char text[32];
+        std::snprintf (text, sizeof (text), format, value);
+        return text;
+    }
+}
+
+int main (int argc, char* argv[])
+{
+    const double seconds = argc > 1 ? std::atof (argv[1]) : 10.0;
+    const bool markdown = argc > 2 && std::string (argv[2]) == "--markdown";
+    const int numSamples = (int) (seconds * 48000.0);
+    const int threadCounts[] = { 1, 2, 4, 8 };
+    const int spareCores = std::max (0, (int) std::thread::hardware_concurrency() - 1);
+    const int maxBlockSize = 128;
+    const Noise noise (numSamples + (warmupBlocks + 1) * maxBlockSize);
+    float peak = 0.0f;
+
+    std::printf ("%u hardware threads, %g s of audio per run at 48 kHz\n", std::thread::hardware_concurrency(), seconds);
+    printRow (markdown, "lines", "block", "workers", "x realtime", "load", "speedup", "efficiency", "peak");
+
+    if (markdown)
+        printRow (true, "---:", "---:", "---:", "---:", "---:", "---:", "---:", "---:");
+
+    for (int numLines : { 32, 64 })
+    {
+        for (int blockSize : { 32, 64, maxBlockSize })
+        {
+            const std::string lines = std::to_string (numLines), block = std::to_string (blockSize);
+            const double baseline = timeRender (noise, numLines, 0, blockSize, numSamples, peak);
+            printRow (markdown, lines, block, "none", formatValue ("%.1f", seconds / baseline),
+                      formatValue ("%.1f%%", 100.0 * baseline / seconds), "-", "-", formatValue ("%.3f", peak));
+
+            for (int numThreads : threadCounts)
+            {
+                if (numThreads > spareCores)
+                {
+                    // a README table just leaves these out
+                    if (! markdown)
+                        std::printf ("%5d %6d %8d   skipped, not enough cores\n", numLines, blockSize, numThreads);
+
+                    continue;
+                }
+
+                const double threaded = timeRender (noise, numLines, numThreads, blockSize, numSamples, peak);
+                const double speedup = baseline / threaded;
+
+                printRow (markdown, lines, block, std::to_string (numThreads), formatValue ("%.1f", seconds / threaded),
+                          formatValue ("%.1f%%", 100.0 * threaded / seconds), formatValue ("%.2f", speedup),
+                          formatValue ("%.0f%%", 100.0 * speedup / numThreads), formatValue ("%.3f", peak));
+            }
+        }
+    }
+
+    return 0;
+}
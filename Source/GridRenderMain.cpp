@@ -0,0 +1,56 @@
+/*
+  ==============================================================================
+
+    GridRenderMain.cpp
+
+    Command line front end for SchroederVerbGridRenderer, built by
+    SchroederVerbGridRender.jucer as a console app so grid renders don't
+    need a host or the plugin.
+
+    usage: schroederverb_gridrender <input audio> <spec.json> <output dir> [numThreads]
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "GridRenderer.h"
+
+#include <iostream>
+
+int main (int argc, char* argv[])
+{
+    if (argc < 4)
+    {
+        std::cerr << "usage: schroederverb_gridrender <input audio> <spec.json> <output dir> [numThreads]" << std::endl;
+        return 1;
+    }
+
+    // relative paths are taken from wherever we were started
+    auto cwd = juce::File::getCurrentWorkingDirectory();
+    auto inputFile = cwd.getChildFile (argv[1]);
+    auto specFile = cwd.getChildFile (argv[2]);
+    auto outputDir = cwd.getChildFile (argv[3]);
+    const int numThreads = argc > 4 ? juce::String (argv[4]).getIntValue() : juce::SystemStats::getNumCpus();
+
+    SchroederVerbGridRenderer renderer;
+    auto result = renderer.loadInput (inputFile);
+
+    if (result.wasOk())
+        result = renderer.loadSpec (specFile);
+
+    if (result.wasOk())
+    {
+        std::cout << "rendering " << renderer.getNumConfigs() << " configurations on "
+                  << juce::jmax (1, numThreads) << " threads into " << outputDir.getFullPathName() << std::endl;
+
+        result = renderer.render (outputDir, numThreads);
+    }
+
+    if (result.failed())
+    {
+        std::cerr << result.getErrorMessage() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
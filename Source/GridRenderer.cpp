@@ -0,0 +1,366 @@
+/*
+  ==============================================================================
+
+    GridRenderer.cpp
+
+  ==============================================================================
+*/
+
+#include "GridRenderer.h"
+
+//==============================================================================
+// one per pool thread: owns a core and an output buffer, and keeps taking the next unrendered configuration
+class SchroederVerbGridRenderer::RenderWorker  : public juce::ThreadPoolJob
+{
+public:
+    RenderWorker (const SchroederVerbGridRenderer& owner, const juce::File& outputDir, std::atomic<int>& nextIndex,
+                  juce::Array<juce::var>& results)
+        : juce::ThreadPoolJob ("SchroederVerb render worker"),
+          mOwner (owner), mOutputDir (outputDir), mNextIndex (nextIndex), mResults (results)
+    {
+    }
+
+    JobStatus runJob() override
+    {
+        const auto& input = mOwner.mInput;
+        const double sampleRate = mOwner.mInputSampleRate;
+        const int blockSize = mOwner.mBlockSize;
+        const int inputLength = input.getNumSamples();
+        const int totalLength = inputLength + juce::roundToInt (mOwner.mTailSeconds * sampleRate);
+
+        // the delay lines are allocated once per worker here, every configuration after that only needs a reset()
+        mCore.setQualityMode (SchroederVerbCore::qualityFull); // renders must not depend on how busy the machine is
+        mCore.prepare (sampleRate, blockSize);
+        mOutput.setSize (2, totalLength);
+
+        for (int index = mNextIndex++; index < mOwner.mConfigs.size(); index = mNextIndex++)
+        {
+            if (shouldExit())
+                break;
+
+            // each slot of mResults is only ever written by the worker that took its index
+            mResults.getReference (index) = renderConfig (index, totalLength);
+        }
+
+        return jobHasFinished;
+    }
+
+private:
+    const SchroederVerbGridRenderer& mOwner;
+    juce::File mOutputDir;
+    std::atomic<int>& mNextIndex;
+    juce::Array<juce::var>& mResults;
+
+    SchroederVerbCore mCore;
+    juce::AudioBuffer<float> mOutput;
+
+    // renders one configuration and writes its file, returns its manifest entry or an error string
+    juce::var renderConfig (int index, int totalLength)
+    {
+        const auto& config = mOwner.mConfigs.getReference (index);
+        const auto& input = mOwner.mInput;
+        const int blockSize = mOwner.mBlockSize;
+        const int inputLength = input.getNumSamples();
+
+        // back to silence, then the configuration, exactly like a freshly prepared core
+        mCore.reset();
+
+        for (int stage = 0; stage < NUMER; ++stage)
+            mCore.setParameter (SchroederVerbCore::erDelayMs, stage, config.erDelaysMs[stage]);
+
+        for (int channel = 0; channel < NUMFBCF; ++channel)
+        {
+            mCore.setParameter (SchroederVerbCore::combDelayMs, channel, config.combDelaysMs[channel]);
+            mCore.setParameter (SchroederVerbCore::combFeedback, channel, config.combFeedbacks[channel]);
+        }
+
+        mCore.setParameter (SchroederVerbCore::matrixOut, 0, config.matrixLeft);
+        mCore.setParameter (SchroederVerbCore::matrixOut, 1, config.matrixRight);
+
+        // copy the input in (mono sources feed both channels), the core then renders in place block by block
+        mOutput.clear();
+
+        for (int channel = 0; channel < 2; ++channel)
+            mOutput.copyFrom (channel, 0, input, juce::jmin (channel, input.getNumChannels() - 1), 0, inputLength);
+
+        for (int pos = 0; pos < totalLength; pos += blockSize)
+        {
+            const int numSamples = juce::jmin (blockSize, totalLength - pos);
+            float* channels[2] = { mOutput.getWritePointer (0, pos), mOutput.getWritePointer (1, pos) };
+
+            mCore.processPlanar (channels, channels, 2, numSamples);
+        }
+
+        auto outputFile = mOutputDir.getChildFile (juce::String::formatted ("render_%05d.wav", index));
+        outputFile.deleteFile();
+        std::unique_ptr<juce::OutputStream> stream (outputFile.createOutputStream());
+
+        juce::WavAudioFormat wav;
+        std::unique_ptr<juce::AudioFormatWriter> writer;
+
+        // 32-bit float, so a hot configuration keeps its overs instead of being clipped at 0 dBFS
+        if (stream != nullptr)
+            writer.reset (wav.createWriterFor (stream.get(), mOwner.mInputSampleRate, 2, 32, {}, 0));
+
+        if (writer == nullptr)
+            return "could not write " + outputFile.getFullPathName();
+
+        stream.release(); // the writer owns the stream now
+        writer->writeFromAudioSampleBuffer (mOutput, 0, totalLength);
+
+        // the peak tells dataset users which files would clip once they're converted to a fixed point format
+        const float peak = mOutput.getMagnitude (0, totalLength);
+
+        auto entry = configToVar (config);
+        entry.getDynamicObject()->setProperty ("file", outputFile.getFileName());
+        entry.getDynamicObject()->setProperty ("peak", peak);
+        entry.getDynamicObject()->setProperty ("clipped", peak > 1.0f);
+        return entry;
+    }
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (RenderWorker)
+};
+
+//==============================================================================
+SchroederVerbGridRenderer::SchroederVerbGridRenderer()
+    : mInputSampleRate (44100.0), mTailSeconds (2.0), mBlockSize (512)
+{
+}
+
+juce::Result SchroederVerbGridRenderer::loadInput (const juce::File& inputFile)
+{
+    juce::AudioFormatManager formatManager;
+    formatManager.registerBasicFormats();
+
+    std::unique_ptr<juce::AudioFormatReader> reader (formatManager.createReaderFor (inputFile));
+
+    if (reader == nullptr)
+        return juce::Result::fail ("could not open " + inputFile.getFullPathName());
+
+    const int numChannels = juce::jlimit (1, 2, (int) reader->numChannels);
+    const int numSamples = (int) reader->lengthInSamples;
+
+    mInput.setSize (numChannels, numSamples);
+    reader->read (&mInput, 0, numSamples, 0, true, numChannels > 1);
+    mInputSampleRate = reader->sampleRate;
+
+    return juce::Result::ok();
+}
+
+juce::Result SchroederVerbGridRenderer::loadSpec (const juce::File& specFile)
+{
+    juce::var spec;
+    auto parseResult = juce::JSON::parse (specFile.loadFileAsString(), spec);
+
+    if (parseResult.failed())
+        return parseResult;
+
+    return loadSpec (spec);
+}
+
+juce::Result SchroederVerbGridRenderer::loadSpec (const juce::var& spec)
+{
+    if (! spec.isObject())
+        return juce::Result::fail ("grid spec must be a JSON object");
+
+    auto isNumber = [] (const juce::var& value) { return value.isInt() || value.isInt64() || value.isDouble(); };
+
+    // read a list of fixed-length value lists, or fall back to a single default entry.
+    // every value has to be a number that passes isValid, rangeText says what that means in the error
+    auto readLists = [&spec, &isNumber] (const juce::Identifier& name, int length, const double* defaults,
+                                         const auto& isValid, const juce::String& rangeText,
+                                         juce::Array<juce::Array<double>>& lists) -> juce::Result
+    {
+        auto* entries = spec[name].getArray();
+
+        if (entries == nullptr)
+        {
+            lists.add (juce::Array<double> (defaults, length));
+            return juce::Result::ok();
+        }
+
+        for (auto& entry : *entries)
+        {
+            auto* values = entry.getArray();
+
+            if (values == nullptr || values->size() != length)
+                return juce::Result::fail (name.toString() + " entries need " + juce::String (length) + " values");
+
+            juce::Array<double> list;
+
+            for (auto& value : *values)
+            {
+                if (! isNumber (value) || ! isValid ((double) value))
+                    return juce::Result::fail (name.toString() + " entry " + juce::String (lists.size()) + " has "
+                                                + value.toString().quoted() + ", values must be " + rangeText);
+
+                list.add ((double) value);
+            }
+
+            lists.add (list);
+        }
+
+        if (lists.isEmpty())
+            return juce::Result::fail (name.toString() + " is empty");
+
+        return juce::Result::ok();
+    };
+
+    // the defaults come straight from a fresh core so they can't drift apart
+    SchroederVerbCore defaults;
+    double defaultER[NUMER], defaultDelays[NUMFBCF], defaultFeedbacks[NUMFBCF];
+    double defaultTaps[2] = { defaults.getParameter (SchroederVerbCore::matrixOut, 0),
+                              defaults.getParameter (SchroederVerbCore::matrixOut, 1) };
+
+    for (int stage = 0; stage < NUMER; ++stage)
+        defaultER[stage] = defaults.getParameter (SchroederVerbCore::erDelayMs, stage);
+
+    for (int channel = 0; channel < NUMFBCF; ++channel)
+    {
+        defaultDelays[channel] = defaults.getParameter (SchroederVerbCore::combDelayMs, channel);
+        defaultFeedbacks[channel] = defaults.getParameter (SchroederVerbCore::combFeedback, channel);
+    }
+
+    // the core would quietly clamp delays to its delay lines, and a feedback of 100% or more renders a file that
+    // only ever gets louder, so both are errors here rather than surprises in the output
+    const double maxDelayMs = DELAYLINESECONDS * 1000.0;
+    auto isDelay = [maxDelayMs] (double value) { return value >= 0.0 && value <= maxDelayMs; };
+    auto isFeedback = [] (double value) { return value >= 0.0 && value < 100.0; };
+    auto isTap = [] (double value) { return value >= 0.0 && value <= NUMFBCF - 1 && value == std::floor (value); };
+    const juce::String delayRange = "0 to " + juce::String (maxDelayMs) + " ms";
+
+    juce::Array<juce::Array<double>> erLists, delayLists, feedbackLists, tapLists;
+    juce::Result result = juce::Result::ok();
+
+    if ((result = readLists ("erDelaysMs", NUMER, defaultER, isDelay, delayRange, erLists)).failed()
+     || (result = readLists ("combDelaysMs", NUMFBCF, defaultDelays, isDelay, delayRange, delayLists)).failed()
+     || (result = readLists ("combFeedbacks", NUMFBCF, defaultFeedbacks, isFeedback, "at least 0 and below 100 (%)", feedbackLists)).failed()
+     || (result = readLists ("matrixTaps", 2, defaultTaps, isTap, "whole numbers 0 to 3 (OutA..OutD)", tapLists)).failed())
+        return result;
+
+    const juce::var tailSeconds = spec.getProperty ("tailSeconds", mTailSeconds);
+    const juce::var blockSize = spec.getProperty ("blockSize", mBlockSize);
+
+    if (! isNumber (tailSeconds) || (double) tailSeconds < 0.0 || (double) tailSeconds > 600.0)
+        return juce::Result::fail ("tailSeconds has " + tailSeconds.toString().quoted() + ", it must be 0 to 600");
+
+    if (! isNumber (blockSize) || (double) blockSize < 16.0 || (double) blockSize > 8192.0
+         || (double) blockSize != std::floor ((double) blockSize))
+        return juce::Result::fail ("blockSize has " + blockSize.toString().quoted() + ", it must be a whole number from 16 to 8192");
+
+    mTailSeconds = (double) tailSeconds;
+    mBlockSize = (int) blockSize;
+
+    mConfigs.clearQuick();
+
+    for (auto& er : erLists)
+        for (auto& delays : delayLists)
+            for (auto& feedbacks : feedbackLists)
+                for (auto& taps : tapLists)
+                {
+                    Config config;
+
+                    for (int stage = 0; stage < NUMER; ++stage)
+                        config.erDelaysMs[stage] = er[stage];
+
+                    for (int channel = 0; channel < NUMFBCF; ++channel)
+                    {
+                        config.combDelaysMs[channel] = delays[channel];
+                        config.combFeedbacks[channel] = feedbacks[channel];
+                    }
+
+                    config.matrixLeft = juce::roundToInt (taps[0]);
+                    config.matrixRight = juce::roundToInt (taps[1]);
+
+                    mConfigs.add (config);
+                }
+
+    return juce::Result::ok();
+}
+
+juce::Result SchroederVerbGridRenderer::render (const juce::File& outputDir, int numThreads)
+{
+    if (mInput.getNumSamples() == 0)
+        return juce::Result::fail ("no input loaded");
+
+    if (mConfigs.isEmpty())
+        return juce::Result::fail ("no configurations to render");
+
+    auto dirResult = outputDir.createDirectory();
+
+    if (dirResult.failed())
+        return dirResult;
+
+    // one slot per configuration, filled by whichever worker renders it
+    juce::Array<juce::var> results;
+    results.resize (mConfigs.size());
+    std::atomic<int> nextIndex { 0 };
+
+    {
+        // no point in more workers than configurations, each one allocates a core's delay lines
+        const int numWorkers = juce::jlimit (1, mConfigs.size(), numThreads);
+        juce::ThreadPool pool (numWorkers);
+
+        for (int worker = 0; worker < numWorkers; ++worker)
+            pool.addJob (new RenderWorker (*this, outputDir, nextIndex, results), true);
+
+        while (pool.getNumJobs() > 0)
+            juce::Thread::sleep (20);
+    }
+
+    // one entry per configuration in order, so renders[i] always describes mConfigs[i]. failed ones carry their error
+    juce::Array<juce::var> renders;
+    juce::StringArray errors;
+
+    for (int index = 0; index < results.size(); ++index)
+    {
+        const auto& result = results.getReference (index);
+
+        if (result.isObject())
+        {
+            renders.add (result);
+            continue;
+        }
+
+        const auto error = result.isString() ? result.toString() : juce::String ("not rendered");
+        auto entry = configToVar (mConfigs.getReference (index));
+        entry.getDynamicObject()->setProperty ("error", error);
+        renders.add (entry);
+        errors.add (juce::String::formatted ("configuration %d: ", index) + error);
+    }
+
+    auto* manifest = new juce::DynamicObject();
+    manifest->setProperty ("sampleRate", mInputSampleRate);
+    manifest->setProperty ("inputSamples", mInput.getNumSamples());
+    manifest->setProperty ("tailSeconds", mTailSeconds);
+    manifest->setProperty ("blockSize", mBlockSize);
+    manifest->setProperty ("renders", renders);
+
+    outputDir.getChildFile ("manifest.json").replaceWithText (juce::JSON::toString (juce::var (manifest)));
+
+    if (! errors.isEmpty())
+        return juce::Result::fail (errors.joinIntoString ("\n"));
+
+    return juce::Result::ok();
+}
+
+juce::var SchroederVerbGridRenderer::configToVar (const Config& config)
+{
+    auto toArray = [] (const double* values, int length)
+    {
+        juce::Array<juce::var> array;
+
+        for (int i = 0; i < length; ++i)
+            array.add (values[i]);
+
+        return juce::var (array);
+    };
+
+    auto* entry = new juce::DynamicObject();
+    entry->setProperty ("erDelaysMs", toArray (config.erDelaysMs, NUMER));
+    entry->setProperty ("combDelaysMs", toArray (config.combDelaysMs, NUMFBCF));
+    entry->setProperty ("combFeedbacks", toArray (config.combFeedbacks, NUMFBCF));
+    entry->setProperty ("matrixTaps", juce::Array<juce::var> { config.matrixLeft, config.matrixRight });
+
+    return juce::var (entry);
+}
@@ -0,0 +1,85 @@
+/*
+  ==============================================================================
+
+    GridRenderer.h
+
+    Renders one source file through every combination of a parameter grid.
+    The input is decoded once into a shared read-only buffer and the
+    configurations are rendered on a thread pool, each pool thread prepares
+    one SchroederVerbCore and resets it between configurations.
+    Built into the schroederverb_gridrender console app (GridRenderMain.cpp).
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "../SchroederVerbCore/SchroederVerbCore.h"
+
+//==============================================================================
+/**
+    The grid spec is a JSON object. Every key is optional and holds a list of
+    candidate values, missing keys fall back to the SchroederVerbCore defaults:
+
+    {
+        "erDelaysMs":    [[28.31, 19.82, 13.88, 4.52, 1.48], [...]],
+        "combDelaysMs":  [[67.48, 64.04, 82.12, 90.04], [...]],
+        "combFeedbacks": [[77.3, 80.2, 75.3, 73.3], [...]],
+        "matrixTaps":    [[0, 3], [0, 2]],
+        "tailSeconds":   2.0,
+        "blockSize":     512
+    }
+
+    The cartesian product of all lists is rendered, one 32-bit float WAV
+    file per configuration, plus a manifest.json with one entry per
+    configuration in order: its parameters, file, peak and whether it goes
+    over 0 dBFS, or the error if it failed.
+
+    Values are checked before anything is rendered: delays 0 to
+    DELAYLINESECONDS * 1000 ms, feedbacks 0 to below 100% (100% and up
+    never decays), taps whole numbers 0..3, tailSeconds 0 to 600 and
+    blockSize a whole number from 16 to 8192.
+*/
+class SchroederVerbGridRenderer
+{
+public:
+    struct Config
+    {
+        double erDelaysMs[NUMER];
+        double combDelaysMs[NUMFBCF];
+        double combFeedbacks[NUMFBCF];
+        int matrixLeft;
+        int matrixRight;
+    };
+
+    SchroederVerbGridRenderer();
+
+    // decodes the whole file into memory, this is the only time the input is read
+    juce::Result loadInput (const juce::File& inputFile);
+
+    // parses and validates the grid spec and expands it into the list of configurations,
+    // a spec with any value out of range fails as a whole and leaves the previous configurations alone
+    juce::Result loadSpec (const juce::File& specFile);
+    juce::Result loadSpec (const juce::var& spec);
+
+    // renders every configuration into outputDir and writes outputDir/manifest.json
+    juce::Result render (const juce::File& outputDir, int numThreads);
+
+    int getNumConfigs() const { return mConfigs.size(); }
+
+private:
+    class RenderWorker;
+
+    juce::AudioBuffer<float> mInput; // shared by all jobs, never written after loadInput()
+    double mInputSampleRate;
+
+    juce::Array<Config> mConfigs;
+    double mTailSeconds;
+    int mBlockSize;
+
+    static juce::var configToVar (const Config& config);
+
+    //==============================================================================
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SchroederVerbGridRenderer)
+};
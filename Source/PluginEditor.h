@@ -1,63 +1,81 @@
-/*
-  ==============================================================================
-
-    This file contains the basic framework code for a JUCE plugin editor.
-
-  ==============================================================================
-*/
-
-#pragma once
-
-#include <JuceHeader.h>
-#include "PluginProcessor.h"
-
-//==============================================================================
-/**
-*/
-class SchroederVerbAudioProcessorEditor  : public juce::AudioProcessorEditor, public juce::Slider::Listener, public juce::ComboBox::Listener, public juce::ToggleButton::Listener
-{
-public:
-    SchroederVerbAudioProcessorEditor (SchroederVerbAudioProcessor&);
-    ~SchroederVerbAudioProcessorEditor() override;
-
-    //==============================================================================
-    void paint (juce::Graphics&) override;
-    void resized() override;
-
-private:
-    // This reference is provided as a quick way for your editor to
-    // access the processor object that created it.
-    SchroederVerbAudioProcessor& audioProcessor;
-    
-    juce::Slider mERDelayTimeSliderArray[NUMER];
-    
-    juce::Slider mAPGainSlider;
-    
-    juce::Slider mFilterDelayTimesSlider[NUMFBCF];
-    juce::Slider mFilterFeedbackGainSlider[NUMFBCF];
-    
-    
-    juce::ComboBox mMixingMatrixComboxL;
-    juce::ComboBox mMixingMatrixComboxR;
-    
-    juce::ToggleButton mClearButton;
-    
-    
-    void sliderValueChanged(juce::Slider* slider) override;
-    void comboBoxChanged(juce::ComboBox* comboBox) override;
-    void buttonClicked(juce::Button* toggleButton) override;
-    
-    
-    
-    enum MixMatrixOut
-    {
-        outA = 1,
-        outB = 2,
-        outC = 3,
-        outD = 4,
-    };
-   
-    
-    
-    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SchroederVerbAudioProcessorEditor)
-};
+/*
+  ==============================================================================
+
+    This file contains the basic framework code for a JUCE plugin editor.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "PluginProcessor.h"
+
+//==============================================================================
+/**
+*/
+class SchroederVerbAudioProcessorEditor  : public juce::AudioProcessorEditor, public juce::Slider::Listener, public juce::ComboBox::Listener, public juce::ToggleButton::Listener, private juce::Timer
+{
+public:
+    SchroederVerbAudioProcessorEditor (SchroederVerbAudioProcessor&);
+    ~SchroederVerbAudioProcessorEditor() override;
+
+    //==============================================================================
+    void paint (juce::Graphics&) override;
+    void resized() override;
+
+private:
+    // This reference is provided as a quick way for your editor to
+    // access the processor object that created it.
+    SchroederVerbAudioProcessor& audioProcessor;
+    
+    juce::Slider mERDelayTimeSliderArray[NUMER];
+    
+    juce::Slider mAPGainSlider;
+    
+    juce::Slider mFilterDelayTimesSlider[NUMFBCF];
+    juce::Slider mFilterFeedbackGainSlider[NUMFBCF];
+    
+    
+    juce::ComboBox mMixingMatrixComboxL;
+    juce::ComboBox mMixingMatrixComboxR;
+    
+    juce::ToggleButton mClearButton;
+    
+    juce::Label mQualityLabel;
+    juce::ComboBox mQualityCombox;
+    
+    // large network mode, ids are the number of lines and the number of threads + 1
+    juce::Label mNetworkLabel;
+    juce::ComboBox mLinesCombox;
+    juce::ComboBox mThreadsCombox;
+    
+    
+    void sliderValueChanged(juce::Slider* slider) override;
+    void comboBoxChanged(juce::ComboBox* comboBox) override;
+    void buttonClicked(juce::Button* toggleButton) override;
+    void timerCallback() override;
+    
+    
+    
+    enum MixMatrixOut
+    {
+        outA = 1,
+        outB = 2,
+        outC = 3,
+        outD = 4,
+    };
+    
+    // combo box ids are the SchroederVerbCore::QualityMode + 2, so Auto (-1) is id 1
+    enum QualityItem
+    {
+        qualityAutoItem = 1,
+        qualityFullItem = 2,
+        qualityReducedItem = 3,
+        qualityEconomyItem = 4,
+    };
+   
+    
+    
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SchroederVerbAudioProcessorEditor)
+};